@@ -19,24 +19,81 @@
 #pragma config GCP = OFF           // General Code Segment Code Protect (Code protection is disabled)
 #pragma config JTAGEN = OFF        // JTAG Port Enable (JTAG port is disabled)
 
-#define _XTAL_FREQ 8000000
+#include "taktowanie.h"          // FCY i stale czasowe
 #include <xc.h>
 #include <libpic30.h>
 #include <stdlib.h>
 #include "p24FJ128GA010.h"
+#include "praca.h"              // przelaczenie programu poza przerwaniem CN
+#include "pomiar.h"             // czasy przerwan na Timer5
 
-volatile uint16_t numer_programu = 1;
-volatile uint8_t flaga = 0; // flaga informujaca o zmianie programu
-// funkcja opoznienie
-void delay(uint32_t ilosc) {
-    uint32_t i, j;
+// Silnik klatek na Timer2 (preskaler 1:64 -> 16 us na impuls przy 4 MHz).
+// Program liczy kolejna klatke z wyprzedzeniem, a przerwanie wpisuje ja
+// do LATA dokladnie w chwili konca poprzedniej - bez petli NOP, niezaleznie
+// od optymalizacji. Miedzy klatkami CPU spi w Idle().
+#define T2_PRESKALER        64
+#define T2_TCKPS            0b10
+#define OKRES_KLATKI(ms)    ((uint16_t)TIMER_PR(T2_PRESKALER, (ms) * 1000UL))
+
+#define OKRES_LICZNIKA      OKRES_KLATKI(200)   // dawne delay(750)
+#define OKRES_KOLEJKI       OKRES_KLATKI(160)   // dawne delay(600)
+#define OKRES_DLUGI         OKRES_KLATKI(270)   // dawne delay(1000)
+
+#if !TIMER_PR_OK(T2_PRESKALER, 270 * 1000UL)
+#error "Okres klatki nie miesci sie w PR2 - zwieksz preskaler Timer2"
+#endif
+
+// Timer3 - blokada drgan styk?w po wcisnieciu (jednorazowo, 1:8)
+#define T3_TCKPS            0b01
+#define OKRES_BLOKADY       ((uint16_t)TIMER_PR(8, DEBOUNCE_MS * 1000UL))
+
+#if !TIMER_PR_OK(8, DEBOUNCE_MS * 1000UL)
+#error "DEBOUNCE_MS za dlugi dla Timer3 z preskalerem 1:8"
+#endif
+
+// Opis programu: start ustawia stan poczatkowy, krok zwraca kolejna
+// wartosc LATA (i moze zmienic okres_kroku). Stan kazdego programu jest
+// osobny, wiec po powrocie program rusza tam, gdzie zostal przerwany.
+typedef struct {
+    void (*start)(void *stan);
+    uint8_t (*krok)(void *stan);
+    void *stan;
+    uint16_t okres;         // domyslny okres klatki (wartosc PR2)
+} program_t;
+
+// Klatka policzona z wyprzedzeniem - osobna dla kazdego programu, zeby
+// przelaczenie nie gubilo kroku, ktory nie zdazyl sie wyswietlic
+typedef struct {
+    uint8_t wartosc;
+    uint16_t okres;
+    uint8_t gotowa;         // 1 - czeka na przerwanie Timer2
+} klatka_t;
+
+#define LICZBA_PROGRAMOW    9
+
+volatile uint8_t numer_programu = 0;    // indeks w tablicy programy[]
+volatile uint8_t czeka_na_klatke = 0;   // przelaczono, a nowa klatka nie gotowa
+uint16_t okres_kroku;                   // okres liczonej wlasnie klatki
+
+// Pomiar czasu przelaczenia: od wejscia w _CNInterrupt do wpisu LATA,
+// w cyklach Tcy (Timer5 liczy swobodnie z preskalerem 1:1). Wymaganie:
+// przelaczenie w 1 ms - dluzsze liczy opoznienie_przekroczenia
+#define OPOZNIENIE_LIMIT    CYKLE_US(1000)
+volatile uint16_t poczatek_przelaczenia;
+volatile uint8_t trwa_pomiar = 0;
+volatile uint16_t opoznienie_przelaczenia = 0;  // ostatni pomiar
+volatile uint16_t opoznienie_max = 0;           // najgorszy przypadek
+volatile uint16_t opoznienie_przekroczenia = 0; // pomiary ponad limit
+
+#if OPOZNIENIE_LIMIT > 0xFFFF
+#error "OPOZNIENIE_LIMIT nie miesci sie w 16-bitowym pomiarze Timer5"
+#endif
+
+// Czasy wykonania przerwan (pomiar.h) - do podgladu w debuggerze
+pomiar_t pomiar_t2, pomiar_cn, pomiar_t3;
+
+void przelacz_program(uint16_t port, uint32_t chwila);
 
-    for(i = 0; i < ilosc; i++) {
-        for(j = 0; j < 100; j++) {
-            asm("NOP");
-        }
-    }
-}
 // Inicjalizacja port?w i przerwan
 void init() {
     AD1PCFG = 0xFFFF;
@@ -51,233 +108,342 @@ void init() {
     CNEN1bits.CN15IE = 1;   // Wlacz przerwanie dla RD6
     CNEN2bits.CN19IE = 1;   // Wlacz przerwanie dla RD13
     
+    IPC4bits.CNIP = 2;      // Ten sam priorytet co Timer2 - bez zagniezdzen
     IFS1bits.CNIF = 0;      // Wyczysc flage przerwania CN
     IEC1bits.CNIE = 1;      // Wlacz przerwania CN
 }
 
-// Procedura obslugi przerwania przyciskami 
+// Inicjalizacja timerow: Timer2 - zegar klatek, Timer3 - blokada drgan,
+// Timer5 - licznik cykli do pomiaru opoznienia i czasow przerwan (pomiar.h)
+void initTimery() {
+    T2CON = 0;
+    T2CONbits.TCKPS = T2_TCKPS;
+    TMR2 = 0;
+    PR2 = OKRES_LICZNIKA;
+    IPC1bits.T2IP = 2;
+    IFS0bits.T2IF = 0;
+    IEC0bits.T2IE = 1;
+    T2CONbits.TON = 1;
+    
+    T3CON = 0;
+    T3CONbits.TCKPS = T3_TCKPS;
+    PR3 = OKRES_BLOKADY;
+    IPC2bits.T3IP = 2;
+    IFS0bits.T3IF = 0;
+    IEC0bits.T3IE = 1;
+    
+    pomiar_init();
+}
+
+static klatka_t bufor[LICZBA_PROGRAMOW];
+
+// Natychmiastowe zakonczenie biezacej klatki - Timer2 zaczyna od zera,
+// a flaga wywoluje przerwanie zaraz po wyjsciu z obecnego
+static void wymus_klatke() {
+    TMR2 = 0;
+    IFS0bits.T2IF = 1;
+}
+
+// Przerwanie Timer2 - zatrzasniecie klatki aktywnego programu na porcie A.
+// Nowy okres wpisany zaraz po zrownaniu TMR2 z PR2 obowiazuje juz
+// dla zaczynajacej sie klatki. Jesli main nie zdazyl, klatka trwa dalej.
+void __attribute__((interrupt, no_auto_psv)) _T2Interrupt(void) {
+    POMIAR_START();
+    klatka_t *k = &bufor[numer_programu];
+    
+    if(k->gotowa) {
+        LATA = k->wartosc;
+        PR2 = k->okres;
+        k->gotowa = 0;
+        
+        if(trwa_pomiar) {
+            opoznienie_przelaczenia = TMR5 - poczatek_przelaczenia;
+            if(opoznienie_przelaczenia > opoznienie_max) {
+                opoznienie_max = opoznienie_przelaczenia;
+            }
+            if(opoznienie_przelaczenia > OPOZNIENIE_LIMIT) {
+                opoznienie_przekroczenia++;
+            }
+            trwa_pomiar = 0;
+        }
+    }
+    IFS0bits.T2IF = 0;
+    POMIAR_KONIEC(pomiar_t2);
+}
+
+// Procedura obslugi przerwania przyciskami - gorna polowa: migawka portu
+// i chwila wejscia (TMR5) do kolejki, przelacza petla glowna. Kazde
+// zbocze wylacza CN, drgania odcina Timer3 (CN wylaczone do puszczenia)
 void __attribute__((interrupt, no_auto_psv)) _CNInterrupt(void) {
-    __delay32(200);
+    POMIAR_START();
+    uint16_t teraz = TMR5;
+    
+    praca_zglos(przelacz_program, PORTD, teraz);
+    
+    IEC1bits.CNIE = 0;
+    TMR3 = 0;
+    T3CONbits.TON = 1;
+    // Wyczysc flage
+    IFS1bits.CNIF = 0;
+    POMIAR_KONIEC(pomiar_cn);
+}
+
+// Dolna polowa - przelaczenie od razu na pierwszym zboczu. Petla glowna
+// wola ja przy IPL 2, wiec Timer2 nie wchodzi w srodek zmiany klatek
+void przelacz_program(uint16_t port, uint32_t chwila) {
     // Sprawdzenie, kt?ry przycisk zostal nacisniety
     // poprzedni program
-    if(PORTDbits.RD13 == 0) {
-        numer_programu--;
-        flaga = 1;
+    if(!(port & (1u << 13))) {
+        numer_programu = (numer_programu == 0) ? LICZBA_PROGRAMOW - 1 : numer_programu - 1;
     }
     // nastepny program
-    else if(PORTDbits.RD6 == 0) {
-        numer_programu++;
-        flaga = 1;
+    else if(!(port & (1u << 6))) {
+        numer_programu = (numer_programu == LICZBA_PROGRAMOW - 1) ? 0 : numer_programu + 1;
+    }
+    else {
+        return;             // zbocze puszczenia
     }
     
-    while(PORTDbits.RD13 == 0 || PORTDbits.RD6 == 0);
-    // Wyczysc flage
-    IFS1bits.CNIF = 0;
+    poczatek_przelaczenia = (uint16_t)chwila;
+    trwa_pomiar = 1;
+    // Wznowiony program ma zwykle gotowa klatke - pokaz ja od razu,
+    // w przeciwnym razie main policzy ja i wymusi przerwanie
+    if(bufor[numer_programu].gotowa) {
+        wymus_klatke();
+    } else {
+        czeka_na_klatke = 1;
+    }
 }
-//1. 8 bitowy licznik binarny zliczajacy w g?re (0...255)
-void binUP(){
-    unsigned char licznik = 0;
-    flaga = 0;
-    while(!flaga) {
-        LATA = licznik++;
-        delay(750);
+
+// Przerwanie Timer3 - koniec blokady, gdy oba przyciski puszczone
+void __attribute__((interrupt, no_auto_psv)) _T3Interrupt(void) {
+    POMIAR_START();
+    
+    if(PORTDbits.RD13 == 1 && PORTDbits.RD6 == 1) {
+        T3CONbits.TON = 0;
+        IFS1bits.CNIF = 0;
+        IEC1bits.CNIE = 1;
     }
+    IFS0bits.T3IF = 0;
+    POMIAR_KONIEC(pomiar_t3);
+}
+
+// Stany program?w
+typedef struct { uint8_t licznik; } stan_licznika_t;
+typedef struct { uint8_t dziesiatki, jednosci; } stan_bcd_t;
+typedef struct { uint8_t wez; int8_t kierunek; } stan_weza_t;
+typedef struct { uint8_t kolejka, wzor, i, j; } stan_kolejki_t;
+typedef struct { uint8_t lcg; } stan_lcg_t;
+
+//1. 8 bitowy licznik binarny zliczajacy w g?re (0...255)
+void binUP_start(void *s) {
+    ((stan_licznika_t *)s)->licznik = 0;
+}
+uint8_t binUP(void *s) {
+    stan_licznika_t *st = s;
+    return st->licznik++;
 }
 //2. 8 bitowy licznik zliczajacy w d?l (255...0)
-void binDOWN(){
-    unsigned char licznik = 255;
-    flaga = 0;
-    while(!flaga) {
-        LATA = licznik--;
-        delay(750);
-    }
+void binDOWN_start(void *s) {
+    ((stan_licznika_t *)s)->licznik = 255;
+}
+uint8_t binDOWN(void *s) {
+    stan_licznika_t *st = s;
+    return st->licznik--;
 }
 //3. 8 bitowy licznik w kodzie Graya zliczajacy w g?re (repr. 0...255)
-void grayUP(){
-    unsigned char licznik = 0;
-    unsigned char grayCode;
-    flaga = 0;
-    
-    while(!flaga) {
-        grayCode = (licznik >> 1) ^ licznik;
-        LATA = grayCode;
-        licznik++;
-        delay(750);
-    }
+uint8_t grayUP(void *s) {
+    stan_licznika_t *st = s;
+    uint8_t grayCode = (st->licznik >> 1) ^ st->licznik;
+    st->licznik++;
+    return grayCode;
 }
 //4. 8 bitowy licznik w kodzie Graya zliczajacy w d?l (repr. 255...0)
-void grayDOWN(){
-    unsigned char licznik = 255;
-    unsigned char grayCode;
-    flaga = 0;
-    
-    while(!flaga) {
-        grayCode = (licznik >> 1) ^ licznik;
-        LATA = grayCode;
-        licznik--;
-        delay(750);
-    }
+uint8_t grayDOWN(void *s) {
+    stan_licznika_t *st = s;
+    uint8_t grayCode = (st->licznik >> 1) ^ st->licznik;
+    st->licznik--;
+    return grayCode;
 }
 //5. 2x4 bitowy licznik w kodzie BCD zliczajacy w g?re (0...99)
-void bcdUP(){
-    unsigned char dziesiatki = 0;
-    unsigned char jednosci = 0;
-    flaga = 0;
+void bcdUP_start(void *s) {
+    stan_bcd_t *st = s;
+    st->dziesiatki = 0;
+    st->jednosci = 0;
+}
+uint8_t bcdUP(void *s) {
+    stan_bcd_t *st = s;
+    uint8_t wynik = (st->dziesiatki << 4) | st->jednosci;
     
-    while(!flaga) {
-        LATA = (dziesiatki << 4) | jednosci;
-        delay(750);
-        
-        jednosci++;
-        if (jednosci > 9) {
-            jednosci = 0;
-            dziesiatki++;
-        }
-        
-        if (dziesiatki > 9) {
-            dziesiatki = 0;
-        }
+    st->jednosci++;
+    if (st->jednosci > 9) {
+        st->jednosci = 0;
+        st->dziesiatki++;
+    }
+    
+    if (st->dziesiatki > 9) {
+        st->dziesiatki = 0;
     }
+    return wynik;
 }
 //6. 2x4 bitowy licznik w kodzie BCD zliczajacy w d?l (99...0)
-void bcdDOWN() {
-    unsigned char dziesiatki = 9;
-    unsigned char jednosci = 9;
-    flaga = 0;
+void bcdDOWN_start(void *s) {
+    stan_bcd_t *st = s;
+    st->dziesiatki = 9;
+    st->jednosci = 9;
+}
+uint8_t bcdDOWN(void *s) {
+    stan_bcd_t *st = s;
+    uint8_t wynik = (st->dziesiatki << 4) | st->jednosci;
     
-    while(!flaga) {
-        LATA = (dziesiatki << 4) | jednosci;
-        delay(750);
-        
-        if (jednosci == 0) {
-            jednosci = 9;
-            dziesiatki--;
-        } else {
-            jednosci--;
-        }
-        
-        if (dziesiatki == 0 && jednosci == 0) {
-            dziesiatki = 9;
-            jednosci = 9;
-        }
+    if (st->jednosci == 0) {
+        st->jednosci = 9;
+        st->dziesiatki--;
+    } else {
+        st->jednosci--;
     }
+    
+    if (st->dziesiatki == 0 && st->jednosci == 0) {
+        st->dziesiatki = 9;
+        st->jednosci = 9;
+    }
+    return wynik;
 }
 //7. 3 bitowy wezyk poruszajacy sie lewo-prawo
-void snake() {
-    unsigned char wez = 0b00000111;
-    uint16_t kierunek = 1;
-    flaga = 0;
+void snake_start(void *s) {
+    stan_weza_t *st = s;
+    st->wez = 0b00000111;
+    st->kierunek = 1;   // int8_t - na uint16_t porownanie z -1 zalezalo od kompilatora
+}
+uint8_t snake(void *s) {
+    stan_weza_t *st = s;
+    uint8_t wynik = st->wez;
     
-    while(!flaga) {
-        LATA = wez;
-        delay(750);
-        
-        if (kierunek == 1) {
-            wez <<= 1;
-            if (wez > 0b01111000) {
-                wez = 0b11100000;
-                kierunek = -1;
-            }
+    if (st->kierunek == 1) {
+        st->wez <<= 1;
+        if (st->wez > 0b01111000) {
+            st->wez = 0b11100000;
+            st->kierunek = -1;
         }
-        else if (kierunek == -1) {
-            wez >>= 1;
-            if (wez < 0b00000111) {
-                wez = 0b00000111 << 1; // poprawione - teraz wezyk nie pokazuje dwa razy stanów początkowych
-                kierunek = 1;
-            }
+    }
+    else if (st->kierunek == -1) {
+        st->wez >>= 1;
+        if (st->wez < 0b00000111) {
+            st->wez = 0b00000111 << 1; // poprawione - teraz wezyk nie pokazuje dwa razy stanów początkowych
+            st->kierunek = 1;
         }
     }
+    return wynik;
+}
+//8. Kolejka - dawne dwie petle for rozpisane na stan (i, j)
+void kolejka_start(void *s) {
+    stan_kolejki_t *st = s;
+    st->kolejka = 0b00000000;
+    st->wzor = 0b00000001;
+    st->i = 0;
+    st->j = 0;
 }
-//8. Kolejka
-void kolejka() {
-    unsigned char kolejka = 0b00000000;
-    unsigned char wzor;
-    flaga = 0;
+uint8_t kolejka(void *s) {
+    stan_kolejki_t *st = s;
+    uint8_t wynik;
     
-    while(!flaga) {
-        // Reset kolejki po zapelnieniu
-        kolejka = 0b00000000;
-        
-        for (uint16_t i = 0; i < 8 && !flaga; i++) {
-            wzor = 0b00000001;
-            for (uint16_t j = 0; j < 8 - i && !flaga; j++) {
-                LATA = kolejka | wzor;
-                delay(600);
-                // Sprawdzenie czy wyjsc z petli
-                if (flaga) {
-                    return;
-                }
-                // Przesuniecie wzorku
-                if (j != 7 - i)
-                    wzor <<= 1;
-            }
-            // dodanie aktualnej diody do reszty kolejki
-            kolejka |= wzor;
-        }
-        
-        // Wszystkie diody sie swieca - wyswietl przez chwile
-        LATA = 0b11111111;
-        delay(1000); 
-        if (flaga) {
-            return;
-        }
-
+    // Wszystkie diody sie swieca - wyswietl przez chwile i zacznij od nowa
+    if (st->i == 8) {
+        kolejka_start(st);
+        okres_kroku = OKRES_DLUGI;
+        return 0b11111111;
+    }
+    
+    wynik = st->kolejka | st->wzor;
+    // Przesuniecie wzorku albo dolaczenie go do kolejki na koncu drogi
+    if (st->j != 7 - st->i) {
+        st->wzor <<= 1;
+        st->j++;
+    } else {
+        st->kolejka |= st->wzor;
+        st->wzor = 0b00000001;
+        st->i++;
+        st->j = 0;
     }
+    return wynik;
 }
 //9. 6 bitowy generator liczb pseudolosowych oparty o konfiguracje 11100111
-void losowe() {
-    unsigned char lcg = 0b11100111;  // wartosc poczatkowa poprawniona
-    const unsigned char a = 17;  // mnoznik
-    const unsigned char c = 43;  // stala dodawana
-    flaga = 0;
+void losowe_start(void *s) {
+    ((stan_lcg_t *)s)->lcg = 0b11100111;  // wartosc poczatkowa poprawniona
+}
+uint8_t losowe(void *s) {
+    stan_lcg_t *st = s;
+    const uint8_t a = 17;  // mnoznik
+    const uint8_t c = 43;  // stala dodawana
+    uint8_t wynik = st->lcg & 0x3F;   // wyj?cie na port i uciecie dwoch najstarszych 
+    
+    //LCG z maskowaniem 6-bitowym
+    st->lcg = (a * st->lcg + c) & 0x3F;  // 0x3F -> maska 0b00111111
+    return wynik;
+}
 
-    while (!flaga) {
-        LATA = lcg & 0x3F;            // wyj?cie na port i uciecie dwoch najstarszych 
-        delay(1000);
-        //LCG z maskowaniem 6-bitowym
-        lcg = (a * lcg + c) & 0x3F;  // 0x3F -> maska 0b00111111
-        
-    }
+static stan_licznika_t stan_binUP, stan_binDOWN, stan_grayUP, stan_grayDOWN;
+static stan_bcd_t stan_bcdUP, stan_bcdDOWN;
+static stan_weza_t stan_snake;
+static stan_kolejki_t stan_kolejka;
+static stan_lcg_t stan_losowe;
+
+// Rejestr program?w w kolejnosci wyboru przyciskami
+static const program_t programy[LICZBA_PROGRAMOW] = {
+    { binUP_start,   binUP,    &stan_binUP,    OKRES_LICZNIKA },
+    { binDOWN_start, binDOWN,  &stan_binDOWN,  OKRES_LICZNIKA },
+    { binUP_start,   grayUP,   &stan_grayUP,   OKRES_LICZNIKA },
+    { binDOWN_start, grayDOWN, &stan_grayDOWN, OKRES_LICZNIKA },
+    { bcdUP_start,   bcdUP,    &stan_bcdUP,    OKRES_LICZNIKA },
+    { bcdDOWN_start, bcdDOWN,  &stan_bcdDOWN,  OKRES_LICZNIKA },
+    { snake_start,   snake,    &stan_snake,    OKRES_LICZNIKA },
+    { kolejka_start, kolejka,  &stan_kolejka,  OKRES_KOLEJKI },
+    { losowe_start,  losowe,   &stan_losowe,   OKRES_DLUGI },
+};
+
+// Policzenie nastepnej klatki programu n do jego bufora
+void policz_klatke(uint8_t n) {
+    const program_t *p = &programy[n];
+    
+    okres_kroku = p->okres;
+    bufor[n].wartosc = p->krok(p->stan);
+    bufor[n].okres = okres_kroku;
+    bufor[n].gotowa = 1;
 }
+
 // Gl?wna funkcja programu z wyborem programu
 int main(void) {
+    uint8_t i, n;
+    
     init();
+    for(i = 0; i < LICZBA_PROGRAMOW; i++) {
+        programy[i].start(programy[i].stan);
+    }
+    initTimery();
     
     while(1) {
-        if(numer_programu < 1) {
-            numer_programu = 9;
-        } else if(numer_programu > 9) {
-            numer_programu = 1;
+        // Przelaczenia z przerwania CN przy IPL 2 - tak jak w przerwaniu
+        SRbits.IPL = 2;
+        praca_obsluz();
+        SRbits.IPL = 0;
+        
+        n = numer_programu;
+        if(!bufor[n].gotowa) {
+            policz_klatke(n);
         }
-        switch(numer_programu) {
-            case 1:
-                binUP();
-                break;
-            case 2:
-                binDOWN();
-                break;
-            case 3:
-                grayUP();
-                break;
-            case 4:
-                grayDOWN();
-                break;
-            case 5:
-                bcdUP();
-                break;
-            case 6:
-                bcdDOWN();
-                break;
-            case 7:
-                snake();
-                break;
-            case 8:
-                kolejka();
-                break;
-            case 9:
-                losowe();
-                break;
+        // Przerwanie miedzy sprawdzeniem a Idle() zgubiloby klatke, wiec
+        // usypiamy przy IPL 7 - przerwanie budzi CPU, a obsluga rusza
+        // dopiero po przywroceniu IPL 0.
+        SRbits.IPL = 7;
+        if(!praca_czeka() && n == numer_programu && bufor[n].gotowa) {
+            if(czeka_na_klatke) {
+                czeka_na_klatke = 0;
+                wymus_klatke();
+            } else {
+                Idle();
+            }
         }
+        SRbits.IPL = 0;
     }
     return 0;
 }
@@ -20,55 +20,211 @@
 #pragma config GCP = OFF           // General Code Segment Code Protect
 #pragma config JTAGEN = OFF        // JTAG Port Enable
 
-#define _XTAL_FREQ 8000000
+#include "taktowanie.h"          // FCY i stale czasowe
 #include <xc.h>
 #include <libpic30.h>
 #include <stdlib.h>
 #include "p24FJ128GA010.h"
+#include "praca.h"              // zmiana programu poza przerwaniem
+#include "przyciski.h"          // debouncing w przerwaniu Timer4
+#include "pomiar.h"             // czasy przerwan na Timer5
 
-volatile uint16_t numer_programu = 1;
-volatile uint8_t flaga = 0; // flaga informujaca o zmianie programu
-volatile uint16_t predkosc = 0; // wartosc potencjometru
+// Zmienia je tylko petla glowna (obsluga przycisku z kolejki praca.h)
+uint16_t numer_programu = 1;
+uint8_t flaga = 0; // flaga informujaca o zmianie programu
+volatile uint16_t predkosc = 0; // wartosc potencjometru (z przerwania ADC)
 
-// Funkcja opoznienie z regulacja predkosci
-void delay(uint32_t podstawa) {
-    uint32_t ilosc, i, j;
+// Akwizycja potencjometru w tle: ASAM wznawia probkowanie zaraz po
+// konwersji, a Timer3 (SSRC = 010) co OKRES_PROBKI_US konczy je i startuje
+// konwersje. Wyniki trafiaja na zmiane do dwoch polowek bufora (BUFM),
+// przerwanie co ADC_PROBKI konwersji usrednia zapelniona polowke.
+// ADC_SZYBKO - czestsze pomiary i szybki Tad, bez filtra, za to z szumem
+#define ADC_PROBKI          8               // SMPI + 1 - polowka bufora
+#ifdef ADC_SZYBKO
+#define OKRES_PROBKI_US     125UL           // 8 kHz, nowa wartosc co 1 ms
+#define ADC_KONFIGURACJA    ADC_AD1CON3_SZYBKO
+#define ADC_FILTR           0               // bez filtra
+#else
+#define OKRES_PROBKI_US     1000UL          // 1 kHz, nowa wartosc co 8 ms
+#define ADC_KONFIGURACJA    ADC_AD1CON3
+#define ADC_FILTR           2               // filtr: y += (x - y) / 4
+#endif
+#define PR3_PROBKI          TIMER_PR(1, OKRES_PROBKI_US)
+
+#if !TIMER_PR_OK(1, OKRES_PROBKI_US)
+#error "OKRES_PROBKI_US za dlugi dla Timer3 bez preskalera"
+#endif
+
+volatile uint8_t krok = 0;  // Timer2 - czas na kolejny krok animacji
+
+// Timer4 - probkowanie przyciskow co PRZYCISKI_OKRES_US (1:8). Startuje
+// go zbocze CN, staje, gdy przyciski puszczone i ustalone - wtedy znowu CN
+#define T4_TCKPS            0b01
+#define OKRES_PROBKOWANIA   ((uint16_t)TIMER_PR(8, PRZYCISKI_OKRES_US))
+#define MASKA_PRZYCISKOW    ((1u << 13) | (1u << 6))
+
+#if !TIMER_PR_OK(8, PRZYCISKI_OKRES_US)
+#error "PRZYCISKI_OKRES_US za dlugi dla Timer4 z preskalerem 1:8"
+#endif
+
+przyciski_t przyciski;          // tylko przerwanie Timer4
+
+// Czasy wykonania przerwan (pomiar.h) - do podgladu w debuggerze
+pomiar_t pomiar_t2, pomiar_adc, pomiar_cn, pomiar_t4;
+
+void obsluz_przycisk(uint16_t wcisniete, uint32_t chwila);
+
+// Tempo animacji to okres Timer2 (preskaler 1:64, impuls 16 us), ustawiany
+// z potencjometru w kazdym przerwaniu - zmiana galki dziala od nastepnego
+// kroku, bez czekania na koniec klatki
+#define T2_PRESKALER        64
+#define T2_TCKPS            0b10
+
+// Okres kroku w 10 us -> PR2 (dzielenie przez staly preskaler to przesuniecie)
+#define PR2_10US(okres)     TIMER_PR(T2_PRESKALER, (uint32_t)(okres) * 10)
+
+#ifndef KRZYWA_STARA
+// Krzywa wykladnicza: 256 krokow od 500 ms (galka na 0) do 5 ms (na 1023),
+// kazdy o ok. 1,8% szybszy od poprzedniego. Wygenerowane:
+//   [round(50000 * 0.01 ** (i / 255)) for i in range(256)]
+static const uint16_t okresy_10us[256] = {
+    50000, 49105, 48226, 47363, 46515, 45683, 44865, 44062, 43274, 42499, 41739, 40992,
+    40258, 39538, 38830, 38135, 37452, 36782, 36124, 35477, 34842, 34219, 33606, 33005,
+    32414, 31834, 31264, 30705, 30155, 29615, 29085, 28565, 28054, 27552, 27058, 26574,
+    26099, 25631, 25173, 24722, 24280, 23845, 23418, 22999, 22588, 22183, 21786, 21396,
+    21014, 20637, 20268, 19905, 19549, 19199, 18856, 18518, 18187, 17861, 17542, 17228,
+    16919, 16616, 16319, 16027, 15740, 15458, 15182, 14910, 14643, 14381, 14124, 13871,
+    13623, 13379, 13139, 12904, 12673, 12447, 12224, 12005, 11790, 11579, 11372, 11168,
+    10968, 10772, 10579, 10390, 10204, 10021,  9842,  9666,  9493,  9323,  9156,  8992,
+     8831,  8673,  8518,  8366,  8216,  8069,  7924,  7783,  7643,  7507,  7372,  7240,
+     7111,  6983,  6858,  6736,  6615,  6497,  6380,  6266,  6154,  6044,  5936,  5830,
+     5725,  5623,  5522,  5423,  5326,  5231,  5137,  5045,  4955,  4866,  4779,  4694,
+     4610,  4527,  4446,  4367,  4288,  4212,  4136,  4062,  3990,  3918,  3848,  3779,
+     3712,  3645,  3580,  3516,  3453,  3391,  3330,  3271,  3212,  3155,  3098,  3043,
+     2988,  2935,  2882,  2831,  2780,  2730,  2682,  2634,  2586,  2540,  2495,  2450,
+     2406,  2363,  2321,  2279,  2238,  2198,  2159,  2120,  2082,  2045,  2009,  1973,
+     1937,  1903,  1869,  1835,  1802,  1770,  1738,  1707,  1677,  1647,  1617,  1588,
+     1560,  1532,  1505,  1478,  1451,  1425,  1400,  1375,  1350,  1326,  1302,  1279,
+     1256,  1233,  1211,  1190,  1168,  1148,  1127,  1107,  1087,  1068,  1048,  1030,
+     1011,   993,   975,   958,   941,   924,   907,   891,   875,   860,   844,   829,
+      814,   800,   785,   771,   757,   744,   731,   718,   705,   692,   680,   668,
+      656,   644,   632,   621,   610,   599,   588,   578,   567,   557,   547,   537,
+      528,   518,   509,   500
+};
+#endif
+
+#if !TIMER_PR_OK(T2_PRESKALER, 50000UL * 10)
+#error "Najdluzszy krok nie miesci sie w Timer2 - zwieksz T2_PRESKALER"
+#endif
+
+// Okres kroku (w 10 us) dla odczytu potencjometru 0..1023.
+// KRZYWA_STARA - dawne 5 progow bez zachowanego porzadku (podstawa 40 ms
+// razy 1/2, 4, 1/4, 12, 1/8), zeby bylo widac, ze sa rozne stany
+uint16_t okres_kroku(uint16_t odczyt) {
+#ifdef KRZYWA_STARA
+    if (odczyt < 205)           return 4000 / 2;   // szybko
+    else if (odczyt < 410)      return 4000 * 4;   // wolno
+    else if (odczyt < 615)      return 4000 / 4;   // jeszcze szybciej
+    else if (odczyt < 820)      return 4000 * 12;  // najwolniej
+    else                        return 4000 / 8;   // najszybciej
+#else
+    return okresy_10us[odczyt >> 2];
+#endif
+}
+
+// Przerwanie Timer2 - kolejny krok animacji. TMR2 wlasnie sie wyzerowal,
+// wiec nowy PR2 obowiazuje juz w tym okresie. auto_psv - tablica okresow
+// jest w pamieci programu
+void __attribute__((interrupt, auto_psv)) _T2Interrupt(void) {
+    POMIAR_START();
+    uint16_t okres = PR2_10US(okres_kroku(predkosc));
     
-    // Przeliczenie opoznienia na podstawie odczytu z potencjometru
-    // predkosc bedzie w zakresie 0-1023 (10-bitowy ADC)
-    // i dzielmy na 5 rozncyh poziomow predkosci
-    // 5 roznych predkosci bez zachowanego porządku aby było widoczne że istnieje 5 róźnych stanów
-    if (predkosc < 205)         ilosc = podstawa /2;  // szybko
-    else if (predkosc < 410)    ilosc = podstawa * 4;  // wolno
-    else if (predkosc < 615)    ilosc = podstawa /4;  // jeszcze szybciej niz przy 205 wartosci
-    else if (predkosc < 820)    ilosc = podstawa * 12;  // najwolniej 
-    else                        ilosc = podstawa /8;  // najszybiciej
-
-    for(i = 0; i < ilosc; i++) {
-        for(j = 0; j < 100; j++) {
-            asm("NOP");
+    IFS0bits.T2IF = 0;
+    if (TMR2 >= okres) {
+        TMR2 = 0;       // przerwanie spoznione (np. przez CN) - bez przekrecenia
+    }
+    PR2 = okres;
+    krok = 1;
+    POMIAR_KONIEC(pomiar_t2);
+}
+
+// Czeka na kolejny krok albo zmiane programu, w miedzyczasie obsluguje
+// przyciski z kolejki. Idle przy IPL 7 - przerwanie tuz przed Idle()
+// i tak obudzi procesor
+void czekaj_na_krok() {
+    while (!krok && !flaga) {
+        praca_obsluz();
+        SRbits.IPL = 7;
+        if (!krok && !flaga && !praca_czeka()) {
+            Idle();
         }
+        SRbits.IPL = 0;
     }
+    krok = 0;
+}
+
+// Timer2 - takt animacji
+void initTimer2() {
+    T2CON = 0;
+    TMR2 = 0;
+    PR2 = PR2_10US(okres_kroku(predkosc));
+    T2CONbits.TCKPS = T2_TCKPS;
+    IPC1bits.T2IP = 2;        // Ponizej ADC i CN
+    IFS0bits.T2IF = 0;
+    IEC0bits.T2IE = 1;
+    T2CONbits.TON = 1;
 }
 
-// Inicjalizacja ADC do odczytu potencjometru
+// Inicjalizacja ADC - ciagly odczyt potencjometru w tle
 void initADC() {
     // Konfiguracja portu analogowego
     AD1PCFGbits.PCFG5 = 0;    // AN5 jako wejscie analogowe
-    AD1CON1 = 0x00E0;         // SSRC = 111 zakoncz konwersje na samym koncu
+    AD1CON1 = 0;
+    AD1CON1bits.SSRC = 0b010; // Timer3 konczy probkowanie i startuje konwersje
+    AD1CON1bits.ASAM = 1;     // Probkowanie od razu po konwersji
     AD1CON2 = 0;
-    AD1CON3 = 0x1F3F;         // Czas probkowania = 31Tad, Tad = 64Tcy
+    AD1CON2bits.SMPI = ADC_PROBKI - 1; // Przerwanie co ADC_PROBKI wynikow
+    AD1CON2bits.BUFM = 1;     // Dwie polowki bufora po 8 slow
+    AD1CON3 = ADC_KONFIGURACJA; // Tad (i SAMC) z taktowanie.h
     AD1CHS = 5;               // Wybor kanalu AN5 (potencjometr)
+    
+    IPC3bits.AD1IP = 3;       // Ponizej CN
+    IFS0bits.AD1IF = 0;
+    IEC0bits.AD1IE = 1;
     AD1CON1bits.ADON = 1;     // Wlacz modul ADC
+    
+    // Timer3 - tylko wyzwalanie ADC, bez przerwania
+    T3CON = 0;
+    TMR3 = 0;
+    PR3 = PR3_PROBKI;
+    T3CONbits.TON = 1;
 }
 
-// Funkcja do odczytu wartosci potencjometru
-uint16_t czytajPotencjometr() {
-    AD1CON1bits.SAMP = 1;     // Rozpocznij probkowanie
-    __delay32(100);           // Daj czas na probkowanie
-    AD1CON1bits.SAMP = 0;     // Rozpocznij konwersje
-    while (!AD1CON1bits.DONE); // Czekaj na zakonczenie konwersji
-    return ADC1BUF0;          // Zwroc wynik
+// Przerwanie ADC - srednia z polowki bufora, ktora wlasnie sie zapelnila,
+// przez filtr do zmiennej predkosc. Petla animacji tylko ja czyta
+void __attribute__((interrupt, no_auto_psv)) _ADC1Interrupt(void) {
+    POMIAR_START();
+    static uint16_t filtr;          // wynik << ADC_FILTR
+    static uint8_t pierwszy = 1;
+    // BUFS = 1 - przetwornik pisze do gornej polowki, gotowa jest dolna
+    volatile uint16_t *wynik = AD1CON2bits.BUFS ? &ADC1BUF0 : &ADC1BUF8;
+    uint16_t suma = 0;
+    uint8_t i;
+    
+    IFS0bits.AD1IF = 0;
+    for (i = 0; i < ADC_PROBKI; i++) {
+        suma += wynik[i];
+    }
+    suma /= ADC_PROBKI;
+    
+    if (pierwszy) {                 // bez dochodzenia od zera po starcie
+        filtr = suma << ADC_FILTR;
+        pierwszy = 0;
+    } else {
+        filtr += suma - (filtr >> ADC_FILTR);
+    }
+    predkosc = filtr >> ADC_FILTR;
+    POMIAR_KONIEC(pomiar_adc);
 }
 
 // Inicjalizacja portow i przerwan
@@ -88,42 +244,75 @@ void init() {
     IFS1bits.CNIF = 0;        // Wyczysc flage przerwania CN
     IEC1bits.CNIE = 1;        // Wlacz przerwania CN
     
-    // Inicjalizacja ADC
+    // Timer4 - probkowanie przyciskow, uruchamiane przez przerwanie CN
+    przyciski_init(&przyciski, MASKA_PRZYCISKOW);
+    T4CON = 0;
+    T4CONbits.TCKPS = T4_TCKPS;
+    PR4 = OKRES_PROBKOWANIA;
+    IPC6bits.T4IP = 4;        // Jak CN (domyslny priorytet)
+    IFS1bits.T4IF = 0;
+    IEC1bits.T4IE = 1;
+    
+    // Inicjalizacja ADC i taktu animacji, Timer5 - czasy przerwan
+    pomiar_init();
     initADC();
+    initTimer2();
 }
 
-// Procedura obslugi przerwania przyciskami 
+// Procedura obslugi przerwania przyciskami - tylko budzi probkowanie,
+// zbocza (razem z drganiami) liczy dalej Timer4
 void __attribute__((interrupt, no_auto_psv)) _CNInterrupt(void) {
-    __delay32(200);
-    // Sprawdzenie, ktory przycisk zostal nacisniety
+    POMIAR_START();
+    
+    IEC1bits.CNIE = 0;
+    TMR4 = 0;
+    T4CONbits.TON = 1;
+    // Wyczysczenie flagi
+    IFS1bits.CNIF = 0;
+    POMIAR_KONIEC(pomiar_cn);
+}
+
+// Przerwanie Timer4 - probka przyciskow, wcisniecie do kolejki (zmiana
+// programu w petli glownej). Po puszczeniu koniec probkowania, znowu CN
+void __attribute__((interrupt, no_auto_psv)) _T4Interrupt(void) {
+    POMIAR_START();
+    przyciski_zdarzenia_t z;
+    
+    IFS1bits.T4IF = 0;
+    if (przyciski_probka(&przyciski, PORTD, &z) && z.wcisniete) {
+        praca_zglos(obsluz_przycisk, z.wcisniete, TMR5);
+    }
+    if (przyciski_spokoj(&przyciski)) {
+        T4CONbits.TON = 0;
+        IFS1bits.CNIF = 0;
+        IEC1bits.CNIE = 1;
+    }
+    POMIAR_KONIEC(pomiar_t4);
+}
+
+// Dolna polowa - wcisniete przyciski po debouncingu (1 - wcisniety)
+void obsluz_przycisk(uint16_t wcisniete, uint32_t chwila) {
     // poprzedni program
-    if(PORTDbits.RD13 == 0) {
+    if(wcisniete & (1u << 13)) {
         numer_programu--;
         flaga = 1;
     }
     // nastepny program
-    else if(PORTDbits.RD6 == 0) {
+    else if(wcisniete & (1u << 6)) {
         numer_programu++;
         flaga = 1;
     }
-    
-    while(PORTDbits.RD13 == 0 || PORTDbits.RD6 == 0);
-    // Wyczysczenie flagi
-    IFS1bits.CNIF = 0;
 }
 
 // 1. Snake wezyk od prawej do lewej
 void snake() {
     unsigned char wez = 0b00000111;
-    uint16_t kierunek = 1;
+    int8_t kierunek = 1;    // ze znakiem - porownanie z -1 nie zalezy od rozmiaru int
     flaga = 0;
     
     while(!flaga) {
-        // Odczyt potencjometru przed kazda iteracja
-        predkosc = czytajPotencjometr();
-        
         LATA = wez;
-        delay(150); //delay okreslany wartoscia z potencjometru 
+        czekaj_na_krok(); // tempo z potencjometru (Timer2)
         
         if (kierunek == 1) {
             wez <<= 1;
@@ -147,11 +336,8 @@ void binDown(){
     unsigned char licznik = 255;
     flaga = 0;
     while(!flaga) {
-        // program odczytuje przed kazda iteracja wartosc z potencjometru
-        predkosc = czytajPotencjometr();
-        
         LATA = licznik--;
-        delay(150); //delay okreslany wartoscia z potencjometru 
+        czekaj_na_krok(); // tempo z potencjometru (Timer2)
     }
 }
 // Glowna funkcja programu z wyborem programu
@@ -20,63 +20,488 @@
 #pragma config GCP = OFF           // General Code Segment Code Protect
 #pragma config JTAGEN = OFF        // JTAG Port Enable
 
-#define _XTAL_FREQ 8000000
+#include "taktowanie.h"          // FCY i stale czasowe
 #include <xc.h>
 #include <libpic30.h>
 #include <stdlib.h>
 #include "p24FJ128GA010.h"
+#include "trend.h"
+#include "praca.h"              // przycisk poza przerwaniem
+#include "przyciski.h"          // debouncing w przerwaniu Timer4
+#include "pomiar.h"             // czasy przerwan na Timer5
+#include "automat.h"            // automat stanow alarmu kanalu
+#include "sekwencja.h"          // wyniki ADC dla petli glownej
 
 // Definicje stanw alarmu
 #define ALARM_OFF 0
 #define ALARM_MRUGANIE 1
 #define ALARM_WSZYSTKIE 2
+#define ALARM_PRZED 3       // przedalarm - prog zostanie przekroczony w horyzoncie
+#define ALARM_CZUWANIE 4    // nadrzedny OFF i PRZED - czeka na przekroczenie progu
+#define ALARM_TRWA 5        // nadrzedny MRUGANIE i WSZYSTKIE - czeka na spadek
+#define ALARM_KANAL 6       // nadrzedny wszystkich - przycisk wylacza alarm
+#define STANY_ALARMU 7
 
-volatile uint16_t wartosc_potencjometru = 0;  // wartosc odczytana z potencjometru
-volatile uint16_t nastawa_alarmowa = 512;     // nastawa alarmowa (polowa zakresu 0-1023)
-volatile uint8_t stan_alarmu = ALARM_OFF;     // aktualny stan alarmu
-volatile uint32_t licznik_czasu = 0;          // licznik czasu do odmierzania 5 sekund
-volatile uint32_t licznik_mrugania = 0;       // licznik do kontroli czestotliwosci mrugania
-volatile uint8_t mruganie_stan = 0;           // stan mrugania diody (0 - zgaszona, 1 - zapalona)
+// Zdarzenia automatu kanalu
+#define Z_POMIAR 0          // argument - flagi POZIOM_
+#define Z_ESKALACJA 1       // koniec czasu mrugania
+#define Z_PRZYCISK 2
+#define ZDARZENIA_ALARMU 3
 
-// parametry do zarzadzania mruganiem jednej diody i czasem gdy wszystkie sie zaswieca
-#define CZAS_MRUGANIA 450      // calkowity czas fazy mrugania (ilosc iteracji)
-                               // warto?? 450 daje 5 sekund przy delay(25) w main 
-#define CZESTOTL_MRUGANIA 40   // co ile iteracji zmienic stan diody
+// Pomiar kanalu wobec progu i prognozy (argument Z_POMIAR)
+#define POZIOM_PONAD 0x01   // powyzej progu
+#define POZIOM_PONIZEJ 0x02 // ponizej progu i histerezy
+#define POZIOM_BLISKO 0x04  // prognoza siega progu w horyzoncie
+#define POZIOM_DALEKO 0x08  // prognoza nie siega progu w podwojonym horyzoncie
 
+// Pomiary i mruganie dzialaja w przerwaniach, procesor czeka w Idle():
+//  - Timer3 wyzwala konwersje ADC (SSRC = 010), ADC skanuje na zmiane
+//    kanaly z tabeli kanaly[] (CSCNA) i zglasza przerwanie co 16 probek
+//    (SMPI = 15). Przerwanie sumuje probki kazdego kanalu, a co
+//    ADC_NADPROBKOWANIE probek kanalu dopisuje 12-bitowa srednia do trendu
+//    (trend.h) i wystawia wyniki pod blokada sekwencyjna (sekwencja.h).
+//    Petla glowna przy IPL 0 porownuje kopie wynikow z progiem i z prognoza
+//    trendu (mnozenie 64-bit poza przerwaniem) - przedalarm, gdy przy
+//    obecnym tempie wzrostu prog zostanie przekroczony w ciagu horyzontu,
+//  - Timer1 odmierza mruganie i czas do eskalacji wszystkich kanalow.
+// Stan alarmu kazdego kanalu to automat z tablic (automat.h). Przerwania
+// Timer1 i Timer4 (probkowanie przycisku, przyciski.h) tylko zglaszaja
+// zdarzenia do kolejki, a przejscia robi petla glowna przy IPL rownym ich
+// wspolnemu priorytetowi - bez blokad i bez czekania w przerwaniu
+//
+// ALARM_KOMPARATOR - zamiast pomiarow ADC co OKRES_POMIARU_MS prog
+// potencjometru (tylko ten kanal) sprawdza komparator 1: AN5 = C1IN+
+// wobec CVREF ustawionego na prog. Przerwanie komparatora przy przejsciu
+// przez prog w obie strony budzi procesor ze Sleep(), a ADC robi tylko
+// jeden dokladny pomiar przy kazdym przejsciu. Gdy nic nie mruga, procesor
+// spi w Sleep (Timer1 wtedy stoi)
+#define PRIORYTET_ALARMU  3
 
-// Funkcja opoznienia
-void delay(uint32_t czas) {
-    uint32_t i, j;
-    for(i = 0; i < czas; i++) {
-        for(j = 0; j < 100; j++) {
-            asm("NOP");
+// Nowa wartosc kazdego kanalu co OKRES_POMIARU_MS, z 2^ADC_NADPROBKOWANIE_BITY
+// probek. Suma 4^n probek 10-bitowych przesunieta o n daje n bitow wiecej,
+// wiec z 16 i wiecej probek wynik ma 12 bitow (0..ADC_MAKS). Jedna
+// konwersja na dopasowanie Timer3
+#define OKRES_POMIARU_MS  10
+#define LICZBA_KANALOW    2
+#ifndef ADC_NADPROBKOWANIE_BITY
+#define ADC_NADPROBKOWANIE_BITY 4       // 16 probek
+#endif
+#define ADC_NADPROBKOWANIE  (1u << ADC_NADPROBKOWANIE_BITY)
+#define ADC_PRZESUNIECIE  (ADC_NADPROBKOWANIE_BITY - 2)     // suma -> 12 bitow
+#define ADC_PACZKI        (ADC_NADPROBKOWANIE * LICZBA_KANALOW / 16)  // przerwan na wynik
+#define ADC_MAKS          4095
+#define OKRES_PROBKI_US   (OKRES_POMIARU_MS * 1000UL / (LICZBA_KANALOW * ADC_NADPROBKOWANIE))
+#define PR3_POMIARU       TIMER_PR(8, OKRES_PROBKI_US)      // preskaler 1:8
+
+// parametry mrugania potencjometru (dawniej 450 i 40 obrotow petli
+// z delay(25), czyli 5 s i ok. 444 ms)
+#define CZAS_MRUGANIA_MS  5000  // calkowity czas fazy mrugania
+#define OKRES_MRUGANIA_MS 444   // co ile zmienic stan diody
+
+// TC1047A na AN4: 500 mV + 10 mV/C, ADC odniesiony do AVDD (12 bitow)
+#define VDD_MV            3300UL
+#define TC1047_ADC(st)    ((500UL + 10UL * (st)) * ADC_MAKS / VDD_MV)
+
+// Timer1 z preskalerem 1:256 - impuls 64 us, okres mrugania najwyzej 4,19 s
+#define T1_PRESKALER      256
+#define T1_TCKPS          0b11
+#define T1_IMPULSY_MS(ms) ((uint32_t)(ms) * (FCY / 1000UL) / T1_PRESKALER)
+
+// Timer4 - probkowanie przycisku co PRZYCISKI_OKRES_US (1:8). Startuje go
+// zbocze CN, staje, gdy przycisk puszczony i ustalony - wtedy znowu CN
+#define T4_TCKPS          0b01
+#define OKRES_PROBKOWANIA ((uint16_t)TIMER_PR(8, PRZYCISKI_OKRES_US))
+
+przyciski_t przyciski;          // tylko przerwanie Timer4
+
+#if !TIMER_PR_OK(8, OKRES_PROBKI_US)
+#error "OKRES_POMIARU_MS za dlugi dla Timer3 z preskalerem 1:8"
+#endif
+
+#if !TIMER_PR_OK(8, PRZYCISKI_OKRES_US)
+#error "PRZYCISKI_OKRES_US za dlugi dla Timer4 z preskalerem 1:8"
+#endif
+
+#if (ADC_NADPROBKOWANIE_BITY < 4) || (16 % LICZBA_KANALOW)
+#error "12 bitow wymaga co najmniej 16 probek, a LICZBA_KANALOW musi dzielic 16"
+#endif
+
+#if OKRES_PROBKI_US * 1000UL < 14 * ADC_TAD_SZYBKO_NS
+#error "Timer3 szybszy niz probkowanie i konwersja ADC - zmniejsz ADC_NADPROBKOWANIE_BITY"
+#endif
+
+#if !TIMER_PR_OK(T1_PRESKALER, OKRES_MRUGANIA_MS * 1000UL)
+#error "OKRES_MRUGANIA_MS za dlugi dla Timer1 z preskalerem 1:256"
+#endif
+
+// Ustawienia kanalu alarmu. Alarm wlacza sie powyzej prog, a wylacza
+// dopiero ponizej prog - histereza, wiec szum przy progu nie przelacza go.
+// Przedalarm trwa, dopoki prognoza siega progu w podwojonym horyzoncie
+typedef struct {
+    uint8_t an;                 // wejscie ANx
+    uint16_t prog;
+    uint16_t histereza;
+    uint16_t horyzont;          // przedalarm - w pomiarach, 0 - bez przedalarmu
+    uint16_t czas_mrugania_ms;  // mruganie przed eskalacja
+    uint16_t okres_mrugania_ms; // co ile zmiana stanu diody
+    uint16_t dioda;             // mrugajaca dioda (maska LATA)
+    uint16_t diody_eskalacji;   // diody po czasie mrugania
+} kanal_alarmu_t;
+
+// W kolejnosci numerow ANx - w tej kolejnosci skan zapisuje ADC1BUFx
+#define KANAL_TEMPERATURA 0
+#define KANAL_POT         1
+
+#define POMIARY_MS(ms)    ((ms) / OKRES_POMIARU_MS)
+
+static const kanal_alarmu_t kanaly[LICZBA_KANALOW] = {
+    // TC1047A - alarm powyzej 35 C, koniec ponizej 34 C, przedalarm na minute
+    { 4, TC1047_ADC(35), TC1047_ADC(35) - TC1047_ADC(34), POMIARY_MS(60000UL),
+      10000, 1000, 0x0002, 0x00FF },
+    // potencjometr - polowa zakresu, przedalarm na 2 s
+    { 5, 2048, 64, POMIARY_MS(2000), CZAS_MRUGANIA_MS, OKRES_MRUGANIA_MS, 0x0001, 0x00FF },
+};
+
+// Mruganie kanalu. Odliczanie w impulsach Timer1 - Timer1 ustawiany jest
+// zawsze na najblizsze zdarzenie wszystkich kanalow, wiec czasy sa dokladne.
+// Stan alarmu jest w automaty[]
+typedef struct {
+    uint8_t liczy;              // w ALARM_MRUGANIE, do eskalacji
+    uint8_t swieci;             // stan mrugajacej diody
+    uint32_t do_eskalacji;
+    uint16_t do_mrugniecia;
+} alarm_t;
+
+uint16_t pomiary[LICZBA_KANALOW];             // ostatnie wartosci (petla glowna)
+static alarm_t alarmy[LICZBA_KANALOW];
+static automat_t automaty[LICZBA_KANALOW];    // zmienia petla glowna
+static uint16_t okres_timera1;                // biezacy okres Timer1
+
+// Czasy wykonania przerwan (pomiar.h) - do podgladu w debuggerze
+pomiar_t pomiar_cn, pomiar_t4, pomiar_t1, pomiar_adc, pomiar_komparatora;
+
+void obsluz_komparator(uint16_t cmcon, uint32_t chwila);
+
+// Diody wszystkich kanalow naraz
+void odswiez_diody() {
+    uint16_t lata = 0;
+    uint8_t k;
+    
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        uint8_t stan = automaty[k].stan;
+        
+        if(stan == ALARM_WSZYSTKIE) {
+            lata |= kanaly[k].diody_eskalacji;
+        } else if(stan == ALARM_MRUGANIE && alarmy[k].swieci) {
+            lata |= kanaly[k].dioda;
+        } else if(stan == ALARM_PRZED) {
+            lata |= kanaly[k].dioda;    // przedalarm - dioda kanalu swieci stale
+        }
+    }
+    LATA = lata;
+}
+
+// Uplyw impulsow Timer1 we wszystkich mrugajacych kanalach
+void odlicz(uint16_t minelo) {
+    uint8_t k;
+    
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        alarm_t *a = &alarmy[k];
+        
+        if(!a->liczy) {
+            continue;
+        }
+        // Po czas_mrugania_ms przejscie do stanu ALARM_WSZYSTKIE
+        if(a->do_eskalacji <= minelo) {
+            a->liczy = 0;
+            automat_zglos(&automaty[k], Z_ESKALACJA, 0, 0);
+            continue;
+        }
+        a->do_eskalacji -= minelo;
+        if(a->do_mrugniecia <= minelo) {
+            a->do_mrugniecia = T1_IMPULSY_MS(kanaly[k].okres_mrugania_ms);
+            a->swieci = !a->swieci;
+        } else {
+            a->do_mrugniecia -= minelo;
         }
     }
 }
 
-// Inicjalizacja ADC do odczytu potencjometru
+// Nastepne przerwanie Timer1 na najblizsze zdarzenie, Timer1 stoi, gdy nic
+// nie mruga. Uruchomiony Timer1 liczy dalej od ostatniego dopasowania
+void zaplanuj_timer1() {
+    uint16_t najblizej = 0;
+    uint8_t k;
+    
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        alarm_t *a = &alarmy[k];
+        
+        if(!a->liczy) {
+            continue;
+        }
+        if(najblizej == 0 || a->do_mrugniecia < najblizej) {
+            najblizej = a->do_mrugniecia;
+        }
+        if(a->do_eskalacji < najblizej) {
+            najblizej = (uint16_t)a->do_eskalacji;
+        }
+    }
+    
+    okres_timera1 = najblizej;
+    if(najblizej == 0) {
+        T1CONbits.TON = 0;
+        IFS0bits.T1IF = 0;
+        return;
+    }
+    PR1 = najblizej - 1;
+    if(!T1CONbits.TON) {
+        TMR1 = 0;
+        IFS0bits.T1IF = 0;
+        T1CONbits.TON = 1;
+    }
+}
+
+// Wejscie w ALARM_MRUGANIE - od zgaszonej diody, odliczanie od teraz
+void zacznij_mruganie(automat_t *m, const automat_zdarzenie_t *z) {
+    alarm_t *a = &alarmy[m->numer];
+    
+    // Timer1 liczy juz dla innych kanalow - najpierw czas od jego ostatniego
+    // dopasowania (takze tego, ktore czeka na obsluge)
+    if(T1CONbits.TON) {
+        uint16_t minelo;
+        
+        T1CONbits.TON = 0;
+        minelo = TMR1;
+        if(IFS0bits.T1IF) {
+            IFS0bits.T1IF = 0;
+            minelo += okres_timera1;
+        }
+        odlicz(minelo);
+    }
+    
+    a->liczy = 1;
+    a->swieci = 0;
+    a->do_eskalacji = T1_IMPULSY_MS(kanaly[m->numer].czas_mrugania_ms);
+    a->do_mrugniecia = T1_IMPULSY_MS(kanaly[m->numer].okres_mrugania_ms);
+    odswiez_diody();
+    zaplanuj_timer1();
+}
+
+// Wyjscie z ALARM_MRUGANIE (eskalacja, spadek ponizej progu, przycisk)
+void zakoncz_mruganie(automat_t *m, const automat_zdarzenie_t *z) {
+    alarmy[m->numer].liczy = 0;
+    zaplanuj_timer1();
+}
+
+// Wejscie w stan ze stala dioda albo bez diod
+void pokaz_stan(automat_t *m, const automat_zdarzenie_t *z) {
+    odswiez_diody();
+}
+
+// Wejscie w ALARM_OFF
+void wylacz_alarm(automat_t *m, const automat_zdarzenie_t *z) {
+    odswiez_diody();
+#ifdef ALARM_KOMPARATOR
+    // Wciaz powyzej progu - alarm od nowa, jak przy pomiarach co 10 ms
+    if(m->numer == KANAL_POT && CMCONbits.C1OUT) {
+        automat_zglos(m, Z_POMIAR, POZIOM_PONAD, 0);
+    }
+#endif
+}
+
+// Warunki przejsc - flagi pomiaru
+uint8_t ponad(automat_t *m, const automat_zdarzenie_t *z) {
+    return (z->argument & POZIOM_PONAD) != 0;
+}
+
+uint8_t ponizej(automat_t *m, const automat_zdarzenie_t *z) {
+    return (z->argument & POZIOM_PONIZEJ) != 0;
+}
+
+uint8_t blisko(automat_t *m, const automat_zdarzenie_t *z) {
+    return (z->argument & POZIOM_BLISKO) != 0;
+}
+
+uint8_t daleko(automat_t *m, const automat_zdarzenie_t *z) {
+    return (z->argument & POZIOM_DALEKO) != 0;
+}
+
+// Automat kanalu. Przekroczenie progu z OFF i z PRZED jest raz - w stanie
+// nadrzednym ALARM_CZUWANIE, spadek ponizej histerezy z obu stanow alarmu
+// - w ALARM_TRWA, przycisk z kazdego stanu - w ALARM_KANAL. Flagi pomiaru
+// sie wykluczaja (prognoza tylko bez przekroczenia), wiec kolejnosc
+// sprawdzania stan - rodzic nie zmienia wyniku
+static const automat_stan_t stany_alarmu[STANY_ALARMU] = {
+    [ALARM_OFF]       = { ALARM_CZUWANIE, wylacz_alarm, NULL },
+    [ALARM_MRUGANIE]  = { ALARM_TRWA, zacznij_mruganie, zakoncz_mruganie },
+    [ALARM_WSZYSTKIE] = { ALARM_TRWA, pokaz_stan, NULL },
+    [ALARM_PRZED]     = { ALARM_CZUWANIE, pokaz_stan, NULL },
+    [ALARM_CZUWANIE]  = { ALARM_KANAL, NULL, NULL },
+    [ALARM_TRWA]      = { ALARM_KANAL, NULL, NULL },
+    [ALARM_KANAL]     = { AUTOMAT_BRAK, NULL, NULL },
+};
+
+static const automat_przejscie_t przejscia_alarmu[STANY_ALARMU][ZDARZENIA_ALARMU] = {
+    [ALARM_OFF][Z_POMIAR]         = PRZEJSCIE(ALARM_PRZED, blisko, NULL),
+    [ALARM_PRZED][Z_POMIAR]       = PRZEJSCIE(ALARM_OFF, daleko, NULL),
+    [ALARM_CZUWANIE][Z_POMIAR]    = PRZEJSCIE(ALARM_MRUGANIE, ponad, NULL),
+    [ALARM_MRUGANIE][Z_ESKALACJA] = PRZEJSCIE(ALARM_WSZYSTKIE, NULL, NULL),
+    [ALARM_TRWA][Z_POMIAR]        = PRZEJSCIE(ALARM_OFF, ponizej, NULL),
+    [ALARM_KANAL][Z_PRZYCISK]     = PRZEJSCIE(ALARM_OFF, NULL, NULL),
+};
+
+static const automat_opis_t automat_alarmu = {
+    stany_alarmu, &przejscia_alarmu[0][0], STANY_ALARMU, ZDARZENIA_ALARMU, ALARM_OFF
+};
+
+#ifdef ALARM_KOMPARATOR
+// CVRCON dla progu 0..ADC_MAKS - najblizszy z 32 poziomow CVREF (CVRR = 1:
+// CVR/24 AVDD, CVRR = 0: 1/4 AVDD + CVR/32 AVDD), porownanie w 1/96 AVDD.
+// Polowa zakresu (2048) wypada w CVRR = 0, CVR = 8
+uint8_t cvref_dla(uint16_t prog) {
+    int32_t cel = (int32_t)prog * 96;
+    int32_t blad_min = INT32_MAX;
+    uint8_t najlepszy = 0;
+    uint8_t cvr;
+    
+    for(cvr = 0; cvr < 16; cvr++) {
+        int32_t nisko = labs((int32_t)cvr * 4 * ADC_MAKS - cel);
+        int32_t wysoko = labs((24 + (int32_t)cvr * 3) * ADC_MAKS - cel);
+        if(nisko < blad_min) {
+            blad_min = nisko;
+            najlepszy = 0x20 | cvr;     // CVRR = 1
+        }
+        if(wysoko < blad_min) {
+            blad_min = wysoko;
+            najlepszy = cvr;
+        }
+    }
+    return 0x80 | najlepszy;            // CVREN, zrodlo AVDD, bez wyjscia CVREF
+}
+
+// Komparator 1: C1OUT = 1, gdy potencjometr jest powyzej CVREF
+void initKomparator() {
+    CVRCON = cvref_dla(kanaly[KANAL_POT].prog);
+    CMCON = 0;
+    CMCONbits.C1POS = 0;      // wejscie nieodwracajace - CVREF
+    CMCONbits.C1NEG = 1;      // wejscie odwracajace - C1IN+ (AN5)
+    CMCONbits.C1INV = 1;      // odwrocenie - 1 powyzej progu
+    CMCONbits.C1EN = 1;
+    __delay32(FCY / 100000UL);  // 10 us na ustalenie CVREF i komparatora
+    
+    CMCONbits.C1EVT = 0;
+    IPC4bits.CMIP = PRIORYTET_ALARMU;
+    IFS1bits.CMIF = 0;
+    IEC1bits.CMIE = 1;
+    
+    // Potencjometr juz powyzej progu przy starcie - nie bedzie przejscia
+    if(CMCONbits.C1OUT) {
+        IFS1bits.CMIF = 1;
+    }
+}
+
+// ADC tylko na pojedyncze pomiary - wylaczony miedzy nimi
 void initADC() {
-    // Konfiguracja portu analogowego
-    AD1PCFGbits.PCFG5 = 0;    // AN5 jako wejscie analogowe
-    AD1CON1 = 0x00E0;         // SSRC = 111 zako?cz konwersje na samym koncu
+    AD1PCFG &= ~(1u << kanaly[KANAL_POT].an);   // wejscie analogowe (ADC i komparator)
+    AD1CON1 = 0;
+    AD1CON1bits.SSRC = 0b111; // Licznik SAMC konczy probkowanie
     AD1CON2 = 0;
-    AD1CON3 = 0x1F3F;         // Czas probkowania = 31Tad, Tad = 64Tcy
-    AD1CHS = 5;               // Wybor kana?u AN5 (potencjometr)
+    AD1CON3 = ADC_AD1CON3;    // Tad i czas probkowania z taktowanie.h
+    AD1CHS = kanaly[KANAL_POT].an;
+}
+
+// Dokladny pomiar potencjometru
+uint16_t pomiar_potencjometru() {
+    uint16_t wynik;
+    
+    AD1CON1bits.ADON = 1;
+    AD1CON1bits.SAMP = 1;
+    while(!AD1CON1bits.DONE);
+    wynik = ADC1BUF0;
+    AD1CON1bits.ADON = 0;
+    return wynik;
+}
+#else
+static trend_t trendy[LICZBA_KANALOW];
+
+// Wyniki kanalow - pisze przerwanie ADC, czyta petla glowna przy IPL 0.
+// Licznik blokady numeruje wyniki - rozny od widzianego to nowe
+typedef struct {
+    uint16_t wartosc;           // 12 bitow
+    uint16_t max;               // maksimum okna trendu
+    int32_t nachylenie;         // trend_nachylenie()
+} wynik_kanalu_t;
+
+static wynik_kanalu_t wyniki[LICZBA_KANALOW];
+static sekwencja_t sekwencja_wynikow;
+static uint16_t wyniki_widziane;
+
+// Inicjalizacja ADC - skan wszystkich kanalow, konwersje wyzwalane Timer3
+void initADC() {
+    uint16_t skan = 0;
+    uint8_t k;
+    
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        skan |= 1u << kanaly[k].an;
+        trend_init(&trendy[k]);
+    }
+    
+    AD1PCFG &= ~skan;         // Wejscia analogowe kanalow z tabeli
+    AD1CON1 = 0;
+    AD1CON1bits.SSRC = 0b010; // Timer3 konczy probkowanie i startuje konwersje
+    AD1CON1bits.ASAM = 1;     // Probkowanie od razu po konwersji
+    AD1CON2 = 0;
+    AD1CON2bits.CSCNA = 1;    // Skanowanie wejsc z AD1CSSL
+    AD1CON2bits.SMPI = 15;    // Przerwanie po 16 probkach (caly bufor)
+    AD1CON3 = ADC_AD1CON3_SZYBKO;  // Tad 500 ns - czas probkowania daje Timer3
+    AD1CHS = 0;
+    AD1CSSL = skan;
+    
+    IPC3bits.AD1IP = PRIORYTET_ALARMU;
+    IFS0bits.AD1IF = 0;
+    IEC0bits.AD1IE = 1;
     AD1CON1bits.ADON = 1;     // Wlacz modul ADC
+    
+    // Timer3 - tylko wyzwalanie ADC, bez przerwania
+    T3CON = 0;
+    TMR3 = 0;
+    PR3 = PR3_POMIARU;
+    T3CONbits.TCKPS = 0b01;   // 1:8
+    T3CONbits.TON = 1;
 }
+#endif
 
-// Funkcja do odczytu wartosci potencjometru
-uint16_t czytajPotencjometr() {
-    AD1CON1bits.SAMP = 1;     // Rozpocznij probkowanie
-    __delay32(100);           // Daj czas na probkowanie
-    AD1CON1bits.SAMP = 0;     // Rozpocznij konwersje
-    while (!AD1CON1bits.DONE); // Czekaj na zakonczenie konwersji
-    return ADC1BUF0;          // Zwroc wynik
+// Timer1 - mruganie i eskalacja, uruchamiany przez zacznij_mruganie()
+void initTimer1() {
+    T1CON = 0;
+    T1CONbits.TCKPS = T1_TCKPS;
+    IPC0bits.T1IP = PRIORYTET_ALARMU;
+    IFS0bits.T1IF = 0;
+    IEC0bits.T1IE = 1;
 }
 
 // Inicjalizacja portow i przerwan
 void init() {
-    AD1PCFG = 0xFFDF;         // Wszystkie piny cyfrowe oprocz AN5
+    uint8_t k;
+    
+    // Nieuzywane moduly wylaczone (PMD) - mniej pradu w Idle. Zostaja
+    // Timer1, Timer4 (przycisk), Timer5 (pomiar.h), ADC i Timer3 albo
+    // komparatory. Zapis PMD resetuje moduly, wiec na poczatku
+    PMD1 = 0xFFFF;
+    PMD1bits.T1MD = 0;
+    PMD1bits.T4MD = 0;
+    PMD1bits.T5MD = 0;
+    PMD1bits.ADC1MD = 0;
+#ifndef ALARM_KOMPARATOR
+    PMD1bits.T3MD = 0;
+#endif
+    PMD2 = 0xFFFF;            // Input Capture i Output Compare
+    PMD3 = 0xFFFF;            // komparatory, RTCC, PMP, CRC, I2C2
+#ifdef ALARM_KOMPARATOR
+    PMD3bits.CMPMD = 0;
+#endif
+    
+    AD1PCFG = 0xFFFF;         // Piny cyfrowe, analogowe ustawia initADC()
     TRISA = 0x0000;           // Port A jako wyjscie
     TRISD = 0xFFFF;           // Port D jako wejscie
     
@@ -86,99 +511,245 @@ void init() {
     // Wlaczenie przerwan dla przyciskow
     CNEN1bits.CN15IE = 1;     // Wlacz przerwanie dla RD6
     
+    IPC4bits.CNIP = PRIORYTET_ALARMU;
     IFS1bits.CNIF = 0;        // Wyczysc flage przerwania CN
     IEC1bits.CNIE = 1;        // Wlacz przerwania CN
     
-    // Inicjalizacja ADC
+    // Wszystkie diody poczatkowo wylaczone, kanaly w ALARM_OFF
+    LATA = 0x0000;
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        automat_init(&automaty[k], &automat_alarmu, k);
+    }
+    
+    // Timer4 - probkowanie przycisku, uruchamiane przez przerwanie CN
+    przyciski_init(&przyciski, 1u << 6);
+    T4CON = 0;
+    T4CONbits.TCKPS = T4_TCKPS;
+    PR4 = OKRES_PROBKOWANIA;
+    IPC6bits.T4IP = PRIORYTET_ALARMU;
+    IFS1bits.T4IF = 0;
+    IEC1bits.T4IE = 1;
+    
+    // Inicjalizacja Timer1 i ADC, Timer5 - czasy przerwan
+    pomiar_init();
+    initTimer1();
     initADC();
+#ifdef ALARM_KOMPARATOR
+    initKomparator();
+#endif
+}
+
+// Procedura obs?ugi przerwania przyciskami - tylko budzi probkowanie,
+// zbocza (razem z drganiami) liczy dalej Timer4
+void __attribute__((interrupt, auto_psv)) _CNInterrupt(void) {
+    POMIAR_START();
     
-    // Wszystkie diody poczatkowo wylaczone
-    LATA = 0x0000;
+    IEC1bits.CNIE = 0;
+    TMR4 = 0;
+    T4CONbits.TON = 1;
+    
+    // Wyczyszczenie flagi przerwania
+    IFS1bits.CNIF = 0;
+    POMIAR_KONIEC(pomiar_cn);
 }
 
-// Procedura obs?ugi przerwania przyciskami 
-void __attribute__((interrupt, no_auto_psv)) _CNInterrupt(void) {
-    __delay32(200);
+// Przerwanie Timer4 - probka przycisku, wcisniecie RD6 to zdarzenie dla
+// automatow wszystkich kanalow. Po puszczeniu koniec probkowania, znowu CN
+void __attribute__((interrupt, auto_psv)) _T4Interrupt(void) {
+    POMIAR_START();
+    przyciski_zdarzenia_t z;
+    uint8_t k;
     
-    // Sprawdzenie, czy przycisk RD6 zostal nacisniety (wylaczenie alarmu)
-    if(PORTDbits.RD6 == 0) {
-        stan_alarmu = ALARM_OFF;
-        LATA = 0x0000;  // Wylacz wszystkie diody
+    IFS1bits.T4IF = 0;
+    if(przyciski_probka(&przyciski, PORTD, &z) && (z.wcisniete & (1u << 6))) {
+        for(k = 0; k < LICZBA_KANALOW; k++) {
+            automat_zglos(&automaty[k], Z_PRZYCISK, 0, TMR5);
+        }
+    }
+    if(przyciski_spokoj(&przyciski)) {
+        T4CONbits.TON = 0;
+        IFS1bits.CNIF = 0;
+        IEC1bits.CNIE = 1;
     }
+    POMIAR_KONIEC(pomiar_t4);
+}
+
+#ifdef ALARM_KOMPARATOR
+// Przerwanie komparatora - potencjometr przeszedl przez prog. Gorna
+// polowa: migawka CMCON do kolejki (ten sam priorytet co CN), reakcja
+// i pomiar w petli glownej
+void __attribute__((interrupt, auto_psv)) _CompInterrupt(void) {
+    POMIAR_START();
     
-    while(PORTDbits.RD6 == 0);  // Czekaj na zwolnienie przycisku
+    CMCONbits.C1EVT = 0;
+    IFS1bits.CMIF = 0;
+    praca_zglos(obsluz_komparator, CMCON, TMR5);
+    POMIAR_KONIEC(pomiar_komparatora);
+}
+
+// Dolna polowa - petla glowna wola ja przy IPL PRIORYTET_ALARMU
+void obsluz_komparator(uint16_t cmcon, uint32_t chwila) {
+    // Powyzej progu (C1OUT) alarm, ponizej - koniec alarmu
+    automat_wyslij(&automaty[KANAL_POT], Z_POMIAR,
+                   (cmcon & (1u << 6)) ? POZIOM_PONAD : POZIOM_PONIZEJ, chwila);
     
-    // Wyczyszczenie flagi przerwania
-    IFS1bits.CNIF = 0;
+    // Dokladna wartosc dopiero po reakcji - pomiar trwa ok. 0,7 ms.
+    // Pojedynczy pomiar ma 10 bitow, w pomiary[] skala 12-bitowa
+    pomiary[KANAL_POT] = pomiar_potencjometru() << 2;
+}
+
+// Wyniki tylko z dolnej polowy komparatora - poza kolejka nic nie czeka
+static uint8_t nowe_wyniki(void) {
+    return 0;
 }
+#else
+// Przerwanie ADC - co 16 probek. Probki kanalow sa w buforze na zmiane,
+// w kolejnosci z tabeli. Po ADC_PACZKI przerwaniach (co OKRES_POMIARU_MS)
+// nowe wyniki wszystkich kanalow dla petli glownej
+static uint32_t sumy[LICZBA_KANALOW];
+static uint8_t paczki;
 
-void alarm() {
-    // Odczyt wartosci z potencjometru
-    wartosc_potencjometru = czytajPotencjometr();
+// Nowe wartosci wszystkich kanalow - z przerwania ADC. Trend liczy
+// przerwanie (kazda probka), wyniki ida do petli glownej jednym blokiem
+static void zapisz_wyniki(void) {
+    uint8_t k;
     
-    // Sprawdzenie warunkow alarmu
-    switch(stan_alarmu) {
-        case ALARM_OFF:
-            // Jesli wartosc przekroczyla nastawe, uruchom alarm (mruganie jednej diody)
-            if(wartosc_potencjometru > nastawa_alarmowa) {
-                stan_alarmu = ALARM_MRUGANIE;
-                licznik_czasu = 0;       // Zresetuj licznik czasu
-                licznik_mrugania = 0;    // Zresetuj licznik mrugania
-                mruganie_stan = 0;      // Rozpocznij od zgaszonej diody
-            }
-            break;
-            
-        case ALARM_MRUGANIE:
-            // Zwieksz licznik czasu
-            licznik_czasu++;
-            licznik_mrugania++;
-            
-            // Mruganie jedna dioda co CZESTOTL_MRUGANIA cykli
-            if(licznik_mrugania >= CZESTOTL_MRUGANIA) {
-                licznik_mrugania = 0;
-                
-                if(mruganie_stan == 0) {
-                    LATA = 0x0001;  // Zapal pierwsz? diode
-                    mruganie_stan = 1;
-                } else {
-                    LATA = 0x0000;  // Zgas wszystkie diody
-                    mruganie_stan = 0;
-                }
-            }
-            
-            // Po czasie okreslonym przez CZAS_MRUGANIA przejdz do stanu ALARM_WSZYSTKIE
-            if(licznik_czasu >= CZAS_MRUGANIA) {
-                stan_alarmu = ALARM_WSZYSTKIE;
-            }
-            
-            // Jesli wartosc spadla ponizej nastawy, wylacz alarm
-            if(wartosc_potencjometru < nastawa_alarmowa) {
-                stan_alarmu = ALARM_OFF;
-                LATA = 0x0000;  // Wylacz wszystkie diody
-            }
-            break;
-            
-        case ALARM_WSZYSTKIE:
-            LATA = 0x00FF;  // Zapal wszystkie diody 
-            
-            // Jesli wartocs spadla ponizej nastawy, wylacz alarm
-            if(wartosc_potencjometru < nastawa_alarmowa) {
-                stan_alarmu = ALARM_OFF;
-                LATA = 0x0000;  // Wylacz wszystkie diody
-            }
-            break;
+    sekwencja_zapis(&sekwencja_wynikow);
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        uint16_t wartosc = (uint16_t)(sumy[k] >> ADC_PRZESUNIECIE);
+        
+        sumy[k] = 0;
+        trend_probka(&trendy[k], wartosc);
+        wyniki[k].wartosc = wartosc;
+        wyniki[k].max = trend_max(&trendy[k]);
+        wyniki[k].nachylenie = trend_nachylenie(&trendy[k]);
     }
+    sekwencja_koniec(&sekwencja_wynikow);
 }
 
-// Glowna funkcja programu
+// Pomiar kanalu wobec progu i prognozy - flagi POZIOM_ dla Z_POMIAR
+static uint16_t poziom_kanalu(const kanal_alarmu_t *kanal, const wynik_kanalu_t *w) {
+    uint16_t poziom = 0;
+    
+    if(w->wartosc > kanal->prog) {
+        poziom = POZIOM_PONAD;
+    } else {
+        if(w->wartosc < kanal->prog - kanal->histereza) {
+            poziom = POZIOM_PONIZEJ;
+        }
+        // Przedalarm - blisko w horyzoncie, koniec dopiero w podwojonym
+        if(kanal->horyzont == 0) {
+            // bez przedalarmu
+        } else if(!trend_prognoza_z(w->nachylenie, w->max, kanal->prog, 2 * kanal->horyzont)) {
+            poziom |= POZIOM_DALEKO;
+        } else if(trend_prognoza_z(w->nachylenie, w->max, kanal->prog, kanal->horyzont)) {
+            poziom |= POZIOM_BLISKO;
+        }
+    }
+    return poziom;
+}
+
+// Czy przerwanie ADC wystawilo wyniki, ktorych petla glowna nie widziala
+static uint8_t nowe_wyniki(void) {
+    return sekwencja_wynikow != wyniki_widziane;
+}
+
+// Dolna polowa pomiaru - w petli glownej przy IPL 0, wiec przerwanie ADC
+// moze trafic w kopie (wtedy kopia od nowa). Zdarzenia automatow dopiero
+// przy IPL alarmu, jak inne zgloszenia do kolejki
+static void sprawdz_kanaly(void) {
+    wynik_kanalu_t kopia[LICZBA_KANALOW];
+    uint16_t poziomy[LICZBA_KANALOW];
+    uint16_t w;
+    uint8_t k;
+    
+    if(!nowe_wyniki()) {
+        return;
+    }
+    do {
+        w = sekwencja_odczyt(&sekwencja_wynikow);
+        for(k = 0; k < LICZBA_KANALOW; k++) {
+            kopia[k] = wyniki[k];
+        }
+    } while(sekwencja_ponow(&sekwencja_wynikow, w));
+    wyniki_widziane = w;
+    
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        pomiary[k] = kopia[k].wartosc;
+        poziomy[k] = poziom_kanalu(&kanaly[k], &kopia[k]);
+    }
+    
+    SRbits.IPL = PRIORYTET_ALARMU;
+    for(k = 0; k < LICZBA_KANALOW; k++) {
+        if(poziomy[k]) {
+            automat_zglos(&automaty[k], Z_POMIAR, poziomy[k], 0);
+        }
+    }
+    SRbits.IPL = 0;
+}
+
+void __attribute__((interrupt, auto_psv)) _ADC1Interrupt(void) {
+    POMIAR_START();
+    volatile uint16_t *bufor = &ADC1BUF0;
+    uint8_t i;
+    
+    IFS0bits.AD1IF = 0;
+    
+    for(i = 0; i < 16; i++) {
+        sumy[i % LICZBA_KANALOW] += bufor[i];
+    }
+    if(++paczki >= ADC_PACZKI) {
+        paczki = 0;
+        zapisz_wyniki();
+    }
+    POMIAR_KONIEC(pomiar_adc);
+}
+#endif
+
+// Przerwanie Timer1 - zmiana stanu diody albo koniec fazy mrugania
+void __attribute__((interrupt, auto_psv)) _T1Interrupt(void) {
+    POMIAR_START();
+    
+    IFS0bits.T1IF = 0;
+    odlicz(okres_timera1);
+    odswiez_diody();
+    zaplanuj_timer1();
+    POMIAR_KONIEC(pomiar_t1);
+}
+
+// Glowna funkcja programu - zdarzenia alarmow z kolejki, miedzy
+// przerwaniami procesor spi
 int main(void) {
     init();
     
     while(1) {
-        alarm();
+#ifndef ALARM_KOMPARATOR
+        sprawdz_kanaly();       // nowe wyniki ADC - przy IPL 0
+#endif
         
-        delay(25);
+        // Przy IPL alarmu ADC, Timer1 i komparator nie wejda w srodek
+        // przejscia automatu - tak jak dawniej w przerwaniu CN
+        SRbits.IPL = PRIORYTET_ALARMU;
+        praca_obsluz();
+        automat_obsluz();
+        
+        // IPL 7 - przerwanie miedzy sprawdzeniem a Idle()/Sleep() obudzi
+        // procesor zaraz po nim
+        SRbits.IPL = 7;
+        if(!praca_czeka() && !automat_czeka() && !nowe_wyniki()) {
+#ifdef ALARM_KOMPARATOR
+            // Timer1 (mruganie) i Timer4 (przycisk) licza tylko w Idle
+            if(T1CONbits.TON || T4CONbits.TON) {
+                Idle();
+            } else {
+                Sleep();
+            }
+#else
+            Idle();
+#endif
+        }
+        SRbits.IPL = 0;
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=main.c
+SOURCEFILES_QUOTED_IF_SPACED=main.c ../common/trend.c ../common/praca.c ../common/przyciski.c ../common/automat.c ../common/kolejka.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o ${OBJECTDIR}/_ext/1270477542/trend.o ${OBJECTDIR}/_ext/1270477542/praca.o ${OBJECTDIR}/_ext/1270477542/przyciski.o ${OBJECTDIR}/_ext/1270477542/automat.o ${OBJECTDIR}/_ext/1270477542/kolejka.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d ${OBJECTDIR}/_ext/1270477542/trend.o.d ${OBJECTDIR}/_ext/1270477542/praca.o.d ${OBJECTDIR}/_ext/1270477542/przyciski.o.d ${OBJECTDIR}/_ext/1270477542/automat.o.d ${OBJECTDIR}/_ext/1270477542/kolejka.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/main.o
+OBJECTFILES=${OBJECTDIR}/main.o ${OBJECTDIR}/_ext/1270477542/trend.o ${OBJECTDIR}/_ext/1270477542/praca.o ${OBJECTDIR}/_ext/1270477542/przyciski.o ${OBJECTDIR}/_ext/1270477542/automat.o ${OBJECTDIR}/_ext/1270477542/kolejka.o
 
 # Source Files
-SOURCEFILES=main.c
+SOURCEFILES=main.c ../common/trend.c ../common/praca.c ../common/przyciski.c ../common/automat.c ../common/kolejka.c
 
 
 
@@ -89,18 +89,78 @@ MP_LINKER_FILE_OPTION=,--script=p24FJ128GA010.gld
 # ------------------------------------------------------------------------------------
 # Rules for buildStep: compile
 ifeq ($(TYPE_IMAGE), DEBUG_RUN)
-${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/bac7d4daba1c362990d5043f7f08753e425a30ed .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/271162bac6f9f534fe5bd2311152f51543c346c6 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/main.o.d 
 	@${RM} ${OBJECTDIR}/main.o 
-	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/trend.o: ../common/trend.c  .generated_files/flags/default/f66e66f1f2a6c414563b3b6de61af427baa830c1 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/trend.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/trend.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/trend.c  -o ${OBJECTDIR}/_ext/1270477542/trend.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/trend.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/praca.o: ../common/praca.c  .generated_files/flags/default/fd19c4b231ed97cb844a0e3bd7634345f4448318 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/praca.c  -o ${OBJECTDIR}/_ext/1270477542/praca.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/praca.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/przyciski.o: ../common/przyciski.c  .generated_files/flags/default/9c8f9566d0b524a9180d476051ffdaaa90d0b12b .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/przyciski.c  -o ${OBJECTDIR}/_ext/1270477542/przyciski.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/przyciski.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/automat.o: ../common/automat.c  .generated_files/flags/default/50897f9d2a148e72671e59bbbe466378297cd255 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/automat.c  -o ${OBJECTDIR}/_ext/1270477542/automat.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/automat.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/kolejka.o: ../common/kolejka.c  .generated_files/flags/default/22bdbc078af360ec2c27945839665ba3fa9f8e21 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/kolejka.c  -o ${OBJECTDIR}/_ext/1270477542/kolejka.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/kolejka.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
 else
-${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/9d053dd5aea1c4b6308bf171d54bf41e832ba74d .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/1d8b8229cb0ed15b8637a8000324ff79f561e169 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/main.o.d 
 	@${RM} ${OBJECTDIR}/main.o 
-	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/trend.o: ../common/trend.c  .generated_files/flags/default/caaf9189f909cd8a243c613421ba398a0d17d661 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/trend.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/trend.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/trend.c  -o ${OBJECTDIR}/_ext/1270477542/trend.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/trend.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/praca.o: ../common/praca.c  .generated_files/flags/default/b1798941f296e5198ec1ec1d23f8362fa903ea4a .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/praca.c  -o ${OBJECTDIR}/_ext/1270477542/praca.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/praca.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/przyciski.o: ../common/przyciski.c  .generated_files/flags/default/adf0b773c82ddd93b3aaadafbb636bbefec26b46 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/przyciski.c  -o ${OBJECTDIR}/_ext/1270477542/przyciski.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/przyciski.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/automat.o: ../common/automat.c  .generated_files/flags/default/9ec00e9ed80ef6ef1fbf42f814f7c2e9ccf24a23 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/automat.c  -o ${OBJECTDIR}/_ext/1270477542/automat.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/automat.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/kolejka.o: ../common/kolejka.c  .generated_files/flags/default/41cc4bb64b191b616ef3f0161df4785becf559f6 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/kolejka.c  -o ${OBJECTDIR}/_ext/1270477542/kolejka.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/kolejka.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
 endif
 
@@ -18,10 +18,11 @@ limitations under the License.
 #include "lcd.h"
 #include <stdint.h>
 
-#ifndef SYSTEM_PERIPHERAL_CLOCK
-#define SYSTEM_PERIPHERAL_CLOCK 16000000
-#pragma message "This module requires a definition for the peripheral clock frequency.  Assuming 16MHz Fcy (32MHz Fosc).  Define value if this is not correct."
-#endif
+/* SYSTEM_PERIPHERAL_CLOCK (Fcy) comes from the clock configuration shared by
+ * all projects, so the delays below follow any change of the oscillator. */
+#include "taktowanie.h"
+#include "hal.h"
+#include "pomiar.h"
 
 /* This defines the number of cycles per loop through the delay routine.  Spans
  * between 12-18 depending on optimization mode.*/
@@ -47,10 +48,85 @@ limitations under the License.
 // typically > 60ms (double than 8 bit mode)
 #define LCD_STARTUP         (((SYSTEM_PERIPHERAL_CLOCK/1000)*60000)/1000)/CYCLES_PER_DELAY_LOOP
 
-#define LCD_MAX_COLUMN      16
+/* Reject clocks at which the delays above cannot be represented */
+#if LCD_F_INSTR < 1
+#error "SYSTEM_PERIPHERAL_CLOCK too low for the LCD delay loop"
+#endif
+
+#define LCD_MAX_COLUMN      LCD_COLUMNS
+#define LCD_MAX_ROW         LCD_ROWS
+
+/* LCD_USE_BUSY_FLAG selects how the driver knows the controller is ready.
+ * When 1 (default) it reads the busy flag back over the PMP (RS = 0 read)
+ * and sends the next byte as soon as the flag clears.  The fixed delays
+ * above are then only a timeout; if the flag does not clear within them
+ * (R/W line not connected) the driver falls back to fixed delays for good.
+ * When 0 every write waits the worst case datasheet time. */
+#ifndef LCD_USE_BUSY_FLAG
+#define LCD_USE_BUSY_FLAG   1
+#endif
+
+/* Status register read with RS = 0: busy flag and address counter */
+#define LCD_STATUS_BUSY             0x80
+#define LCD_STATUS_ADDRESS_MASK     0x7F
+
+/* One LCD_ReadStatus in LCD_Wait loop units: two PMP read cycles of
+ * WAITB + WAITM + WAITE = 24 Tcy each (PMMODE = 0x03ff), rounded up */
+#define LCD_STATUS_POLL     ((2*24 + CYCLES_PER_DELAY_LOOP - 1)/CYCLES_PER_DELAY_LOOP)
+
+/* LCD_ASYNC selects how bytes reach the controller.  When 1 (default) the
+ * send macros only put an entry into a ring buffer and Timer4 drains it in the
+ * background, waiting each entry's settle time in hardware.  When 0 the
+ * original blocking driver is used and every call busy-waits in LCD_Wait. */
+#ifndef LCD_ASYNC
+#define LCD_ASYNC           1
+#endif
+
+#if LCD_ASYNC
+/* Queue length, must be a power of two.  Use LCD_GetQueueHighWater() and
+ * LCD_GetQueueOverflows() to check if it is large enough. */
+#ifndef LCD_QUEUE_SIZE
+#define LCD_QUEUE_SIZE      64
+#endif
+
+#if (LCD_QUEUE_SIZE & (LCD_QUEUE_SIZE - 1)) != 0
+#error "LCD_QUEUE_SIZE must be a power of two"
+#endif
+
+/* Each queue entry holds the byte in the low 8 bits and flags above it */
+#define LCD_QUEUE_DATA      0x0100      // RS = 1, write to data register
+#define LCD_QUEUE_SLOW      0x0200      // needs the slow instruction settle time
+
+/* Timer4 runs from Fcy with 1:8 prescaler, settle times in timer ticks */
+#define LCD_TIMER_TICKS(us) (((SYSTEM_PERIPHERAL_CLOCK/8/1000)*(us))/1000 + 1)
+#define LCD_F_TICKS         LCD_TIMER_TICKS(40)
+#define LCD_S_TICKS         LCD_TIMER_TICKS(1640)
+
+#if LCD_S_TICKS > 0xFFFF
+#error "SYSTEM_PERIPHERAL_CLOCK too high for the Timer4 1:8 prescaler"
+#endif
+
+/* With the busy flag the timer first fires after the poll interval and the
+ * settle time above is only the timeout for the flag to clear */
+#define LCD_F_POLL_TICKS    LCD_TIMER_TICKS(10)
+#define LCD_S_POLL_TICKS    LCD_TIMER_TICKS(200)
+
+/* Lowest priority, draining the queue must not delay any other interrupt */
+#define LCD_INTERRUPT_PRIORITY  1
+
+#define LCD_SendData(data) LCD_Enqueue ( LCD_QUEUE_DATA | (uint8_t) (data) )
+#define LCD_SendCommand(command, delay) LCD_Enqueue ( ( ( (delay) == LCD_S_INSTR ) ? LCD_QUEUE_SLOW : 0 ) | (uint8_t) (command) )
+#elif LCD_USE_BUSY_FLAG
+#define LCD_SendData(data) { LCD_WaitReady ( ) ; PMADDR = 0x0001; HAL_PMP_ZAPIS(data); pendingDelay = LCD_F_INSTR; }
+#define LCD_SendCommand(command, delay) { LCD_WaitReady ( ) ; PMADDR = 0x0000; HAL_PMP_ZAPIS(command); pendingDelay = delay; }
+#else
+#define LCD_SendData(data) { PMADDR = 0x0001; HAL_PMP_ZAPIS(data); LCD_Wait(LCD_F_INSTR); }
+#define LCD_SendCommand(command, delay) { PMADDR = 0x0000; HAL_PMP_ZAPIS(command); LCD_Wait(delay); }
+#endif
 
-#define LCD_SendData(data) { PMADDR = 0x0001; PMDIN1 = data; LCD_Wait(LCD_F_INSTR); }
-#define LCD_SendCommand(command, delay) { PMADDR = 0x0000; PMDIN1 = command; LCD_Wait(delay); }
+/* The start-up commands are sent before the controller can report its
+ * state, so they are always timed with fixed delays */
+#define LCD_SendCommandFixed(command, delay) { PMADDR = 0x0000; HAL_PMP_ZAPIS(command); LCD_Wait(delay); }
 #define LCD_COMMAND_CLEAR_SCREEN        0x01
 #define LCD_COMMAND_RETURN_HOME         0x02
 #define LCD_COMMAND_ENTER_DATA_MODE     0x06
@@ -60,22 +136,65 @@ limitations under the License.
 #define LCD_COMMAND_MOVE_CURSOR_RIGHT   0x14
 #define LCD_COMMAND_SET_MODE_4_BIT      0x28
 #define LCD_COMMAND_SET_MODE_8_BIT      0x38
-#define LCD_COMMAND_ROW_0_HOME          0x80
-#define LCD_COMMAND_ROW_1_HOME          0xC0
+#define LCD_COMMAND_SET_DDRAM_ADDRESS   0x80
 #define LCD_START_UP_COMMAND_1          0x33    
 #define LCD_START_UP_COMMAND_2          0x32    
 
 /* Private Functions *************************************************/
-static void LCD_CarriageReturn ( void ) ;
-static void LCD_ShiftCursorLeft ( void ) ;
-static void LCD_ShiftCursorRight ( void ) ;
-static void LCD_ShiftCursorUp ( void ) ;
-static void LCD_ShiftCursorDown ( void ) ;
 static void LCD_Wait ( uint32_t ) ;
+static void LCD_ClearShadow ( void ) ;
+#if LCD_USE_BUSY_FLAG
+static uint8_t LCD_ReadStatus ( void ) ;
+#if !LCD_ASYNC
+static void LCD_WaitReady ( void ) ;
+#endif
+#endif
+#if LCD_ASYNC
+static void LCD_QueueInitialize ( void ) ;
+static void LCD_Enqueue ( uint16_t ) ;
+static void LCD_QueueService ( void ) ;
+#endif
 
 /* Private variables ************************************************/
 static uint8_t row ;
 static uint8_t column ;
+
+/* DDRAM address of the first character of each row.  Rows 2 and 3 of a four
+ * line display continue rows 0 and 1 in the controller memory. */
+#if LCD_MAX_ROW == 4
+static const uint8_t rowAddress[LCD_MAX_ROW] = { 0x00 , 0x40 , LCD_MAX_COLUMN , 0x40 + LCD_MAX_COLUMN } ;
+#else
+static const uint8_t rowAddress[LCD_MAX_ROW] = { 0x00 , 0x40 } ;
+#endif
+
+/* Shadow frame buffer.  frameBuffer holds the requested screen contents
+ * (LCD_WriteRow), screenShadow holds what the controller currently shows.
+ * LCD_Flush only sends the cells in which the two differ. */
+static char frameBuffer[LCD_MAX_ROW][LCD_MAX_COLUMN] ;
+static char screenShadow[LCD_MAX_ROW][LCD_MAX_COLUMN] ;
+
+#if LCD_ASYNC
+/* Output queue.  Written only by LCD_Enqueue (main context), read only by
+ * the Timer4 interrupt, so head and tail each have a single writer. */
+static uint16_t queue[LCD_QUEUE_SIZE] ;
+static volatile uint8_t queueHead ;
+static volatile uint8_t queueTail ;
+static volatile bool queueActive ;
+static uint8_t queueHighWater ;
+static uint16_t queueOverflows ;
+static pomiar_t queueServiceTime ;      // Timer4 interrupt cycles (pomiar.h)
+#if LCD_USE_BUSY_FLAG
+static uint16_t queueTimeout ;          // ticks left before the flag is ignored
+#endif
+#endif
+
+#if LCD_USE_BUSY_FLAG
+/* Cleared when the busy flag did not clear within the worst case time */
+static bool busyFlagUsable = true ;
+#if !LCD_ASYNC
+static uint32_t pendingDelay ;          // settle time of the last write
+#endif
+#endif
 /*********************************************************************
  * Function: bool LCD_Initialize(void);
  *
@@ -102,10 +221,19 @@ bool LCD_Initialize ( void )
     LCD_Wait ( LCD_STARTUP ) ;
     LCD_Wait ( LCD_STARTUP ) ;
     
-    LCD_SendCommand ( LCD_START_UP_COMMAND_1 , LCD_F_INSTR) ;
-    LCD_SendCommand ( LCD_START_UP_COMMAND_2 , LCD_F_INSTR) ;
+    LCD_SendCommandFixed ( LCD_START_UP_COMMAND_1 , LCD_F_INSTR) ;
+    LCD_SendCommandFixed ( LCD_START_UP_COMMAND_2 , LCD_F_INSTR) ;
+
+    LCD_SendCommandFixed ( LCD_COMMAND_SET_MODE_8_BIT ,     LCD_F_INSTR ) ;
+
+#if LCD_ASYNC
+    LCD_QueueInitialize ( ) ;
+#elif LCD_USE_BUSY_FLAG
+    /* The fixed commands above waited out their delay, but the busy flag
+     * check of the first LCD_SendCommand needs a timeout to poll within */
+    pendingDelay = LCD_F_INSTR ;
+#endif
 
-    LCD_SendCommand ( LCD_COMMAND_SET_MODE_8_BIT ,     LCD_F_INSTR ) ;
     LCD_SendCommand ( LCD_COMMAND_CURSOR_OFF ,         LCD_F_INSTR ) ;
     LCD_SendCommand ( LCD_COMMAND_ENTER_DATA_MODE ,    LCD_F_INSTR ) ;
 
@@ -168,30 +296,25 @@ void LCD_PutChar ( char inputCharacter )
         case '\r':
             if(lastCharacter != '\n')
             {
-                LCD_CarriageReturn ( ) ;
+                LCD_SetCursor ( row , 0 ) ;
             }
             break ;
 
         case '\n': 
-            if(lastCharacter != '\r')
-            {
-                LCD_CarriageReturn ( ) ;
-            }
-            
-            if (row == 0)
+            LCD_SetCursor ( ( row + 1 ) % LCD_MAX_ROW , 0 ) ;
+            break ;
+
+        case '\b':
+            if (column == 0)
             {
-                LCD_ShiftCursorDown ( ) ;
+                LCD_SetCursor ( ( row + LCD_MAX_ROW - 1 ) % LCD_MAX_ROW , LCD_MAX_COLUMN - 1 ) ;
             }
             else
             {
-                LCD_ShiftCursorUp ( ) ;
+                LCD_SetCursor ( row , column - 1 ) ;
             }
-            break ;
-
-        case '\b':
-            LCD_ShiftCursorLeft ( ) ;
             LCD_PutChar ( ' ' ) ;
-            LCD_ShiftCursorLeft ( ) ;
+            LCD_SetCursor ( row , column - 1 ) ;
             break ;
             
         case '\f':
@@ -201,20 +324,12 @@ void LCD_PutChar ( char inputCharacter )
         default:
             if (column == LCD_MAX_COLUMN)
             {
-                column = 0 ;
-                if (row == 0)
-                {
-                    LCD_SendCommand ( LCD_COMMAND_ROW_1_HOME, LCD_F_INSTR ) ;
-                    row = 1 ;
-                }
-                else
-                {
-                    LCD_SendCommand ( LCD_COMMAND_ROW_0_HOME, LCD_F_INSTR ) ;
-                    row = 0 ;
-                }
+                LCD_SetCursor ( ( row + 1 ) % LCD_MAX_ROW , 0 ) ;
             }
             
             LCD_SendData ( inputCharacter ) ;
+            screenShadow[row][column] = inputCharacter ;
+            frameBuffer[row][column] = inputCharacter ;
             column++ ;
             break ;
     }
@@ -240,83 +355,78 @@ void LCD_ClearScreen ( void )
 
     row = 0 ;
     column = 0 ;
-}
 
-
-/*******************************************************************/
-/*******************************************************************/
-/* Private Functions ***********************************************/
-/*******************************************************************/
-/*******************************************************************/
+    LCD_ClearShadow ( ) ;
+}
 /*********************************************************************
- * Function: static void LCD_CarriageReturn(void)
+ * Function: void LCD_SetCursor(uint8_t row, uint8_t column);
  *
- * Overview: Handles a carriage return
+ * Overview: Moves the cursor to the given position with a single DDRAM
+ *           address command, whatever the display geometry.  Positions
+ *           outside the display are ignored.
  *
  * PreCondition: already initialized via LCD_Initialize()
  *
- * Input: None
+ * Input: uint8_t - row, 0 to LCD_ROWS - 1
+ *        uint8_t - column, 0 to LCD_COLUMNS - 1
  *
  * Output: None
  *
  ********************************************************************/
-static void LCD_CarriageReturn ( void )
+void LCD_SetCursor ( uint8_t newRow , uint8_t newColumn )
 {
-    if (row == 0)
-    {
-        LCD_SendCommand ( LCD_COMMAND_ROW_0_HOME , LCD_F_INSTR) ;
-    }
-    else
+    if (( newRow >= LCD_MAX_ROW ) || ( newColumn >= LCD_MAX_COLUMN ))
     {
-        LCD_SendCommand ( LCD_COMMAND_ROW_1_HOME , LCD_F_INSTR ) ;
+        return ;
     }
-    column = 0 ;
+
+    LCD_SendCommand ( LCD_COMMAND_SET_DDRAM_ADDRESS | ( rowAddress[newRow] + newColumn ) , LCD_F_INSTR ) ;
+    row = newRow ;
+    column = newColumn ;
 }
 /*********************************************************************
- * Function: static void LCD_ShiftCursorLeft(void)
+ * Function: void LCD_WriteRow(uint8_t row, const char* text);
  *
- * Overview: Shifts cursor left one spot (wrapping if required)
+ * Overview: Writes a row of text into the shadow frame buffer.  The text is
+ *           truncated to the display width and padded with spaces.  Nothing
+ *           is sent to the LCD until LCD_Flush() is called.
  *
  * PreCondition: already initialized via LCD_Initialize()
  *
- * Input: None
+ * Input: uint8_t - row to write, 0 to LCD_ROWS - 1
+ *        const char* - null terminated text
  *
  * Output: None
  *
  ********************************************************************/
-static void LCD_ShiftCursorLeft ( void )
+void LCD_WriteRow ( uint8_t targetRow , const char* text )
 {
     uint8_t i ;
 
-    if (column == 0)
+    if (targetRow >= LCD_MAX_ROW)
+    {
+        return ;
+    }
+
+    for (i = 0 ; i < LCD_MAX_COLUMN ; i++)
     {
-        if (row == 0)
+        if (*text != 0x00)
         {
-            LCD_SendCommand ( LCD_COMMAND_ROW_1_HOME , LCD_F_INSTR ) ;
-            row = 1 ;
+            frameBuffer[targetRow][i] = *text++ ;
         }
         else
         {
-            LCD_SendCommand ( LCD_COMMAND_ROW_0_HOME , LCD_F_INSTR ) ;
-            row = 0 ;
+            frameBuffer[targetRow][i] = ' ' ;
         }
-
-        //Now shift to the end of the row
-        for (i = 0 ; i < ( LCD_MAX_COLUMN - 1 ) ; i++)
-        {
-            LCD_ShiftCursorRight ( ) ;
-        }
-    }
-    else
-    {
-        column-- ;
-        LCD_SendCommand ( LCD_COMMAND_MOVE_CURSOR_LEFT , LCD_F_INSTR ) ;
     }
 }
 /*********************************************************************
- * Function: static void LCD_ShiftCursorRight(void)
+ * Function: void LCD_Flush(void);
  *
- * Overview: Shifts cursor right one spot (wrapping if required)
+ * Overview: Sends to the LCD only the cells of the frame buffer that differ
+ *           from what is currently displayed.  The cursor is moved with a
+ *           single DDRAM address command whenever the next changed cell is
+ *           not the one the controller would auto-increment to.
  *
  * PreCondition: already initialized via LCD_Initialize()
  *
@@ -325,66 +435,144 @@ static void LCD_ShiftCursorLeft ( void )
  * Output: None
  *
  ********************************************************************/
-static void LCD_ShiftCursorRight ( void )
+void LCD_Flush ( void )
 {
-    LCD_SendCommand ( LCD_COMMAND_MOVE_CURSOR_RIGHT , LCD_F_INSTR ) ;
-    column++ ;
+    uint8_t r ;
+    uint8_t c ;
 
-    if (column == LCD_MAX_COLUMN)
+    for (r = 0 ; r < LCD_MAX_ROW ; r++)
     {
-        column = 0 ;
-        if (row == 0)
+        for (c = 0 ; c < LCD_MAX_COLUMN ; c++)
         {
-            LCD_SendCommand ( LCD_COMMAND_ROW_1_HOME , LCD_F_INSTR ) ;
-            row = 1 ;
-        }
-        else
-        {
-            LCD_SendCommand ( LCD_COMMAND_ROW_0_HOME , LCD_F_INSTR ) ;
-            row = 0 ;
+            if (frameBuffer[r][c] == screenShadow[r][c])
+            {
+                continue ;
+            }
+
+            if (( r != row ) || ( c != column ))
+            {
+                LCD_SetCursor ( r , c ) ;
+            }
+
+            LCD_SendData ( frameBuffer[r][c] ) ;
+            screenShadow[r][c] = frameBuffer[r][c] ;
+            column++ ;
         }
     }
 }
+
+
+/*******************************************************************/
+/*******************************************************************/
+/* Private Functions ***********************************************/
+/*******************************************************************/
+/*******************************************************************/
+#if LCD_USE_BUSY_FLAG
 /*********************************************************************
- * Function: static void LCD_ShiftCursorUp(void)
+ * Function: static uint8_t LCD_ReadStatus(void)
  *
- * Overview: Shifts cursor up one spot (wrapping if required)
+ * Overview: Reads the status register (busy flag and address counter)
+ *           over the PMP.  A PMP read returns the data latched by the
+ *           previous read cycle, so the register is read twice.
  *
- * PreCondition: already initialized via LCD_Initialize()
+ * PreCondition: PMP configured by LCD_Initialize()
+ *
+ * Input: None
+ *
+ * Output: uint8_t - busy flag in bit 7, address counter in bits 0-6
+ *
+ ********************************************************************/
+static uint8_t LCD_ReadStatus ( void )
+{
+    uint8_t status ;
+
+    while (PMMODEbits.BUSY)
+    {
+    }
+
+    PMADDR = 0x0000 ;
+    status = HAL_PMP_ODCZYT ( ) ;
+    while (PMMODEbits.BUSY)
+    {
+    }
+    status = HAL_PMP_ODCZYT ( ) ;
+    while (PMMODEbits.BUSY)
+    {
+    }
+
+    return status ;
+}
+#if !LCD_ASYNC
+/*********************************************************************
+ * Function: static void LCD_WaitReady(void)
+ *
+ * Overview: Waits until the controller has finished the previous write.
+ *           Polls the busy flag for at most the settle time of that write,
+ *           after which the flag is no longer trusted and fixed delays are
+ *           used instead.  Returns at once when nothing is pending.
+ *
+ * PreCondition: PMP configured by LCD_Initialize()
  *
  * Input: None
  *
  * Output: None
  *
  ********************************************************************/
-static void LCD_ShiftCursorUp ( void )
+static void LCD_WaitReady ( void )
 {
-    uint8_t i ;
+    uint32_t timeout = pendingDelay ;
 
-    for (i = 0 ; i < LCD_MAX_COLUMN ; i++)
+    pendingDelay = 0 ;
+
+    if (timeout == 0)
+    {
+        return ;
+    }
+
+    if (busyFlagUsable == false)
+    {
+        LCD_Wait ( timeout ) ;
+        return ;
+    }
+
+    /* Each poll takes LCD_STATUS_POLL loop units of the timeout */
+    while (( LCD_ReadStatus ( ) & LCD_STATUS_BUSY ) != 0)
     {
-        LCD_ShiftCursorLeft ( ) ;
+        if (timeout <= LCD_STATUS_POLL)
+        {
+            busyFlagUsable = false ;
+            return ;
+        }
+        timeout -= LCD_STATUS_POLL ;
     }
 }
+#endif
+#endif
 /*********************************************************************
- * Function: static void LCD_ShiftCursorDown(void)
+ * Function: static void LCD_ClearShadow(void)
  *
- * Overview: Shifts cursor down one spot (wrapping if required)
+ * Overview: Marks the whole screen as blank in both the frame buffer and
+ *           the shadow of the displayed contents.
  *
- * PreCondition: already initialized via LCD_Initialize()
+ * PreCondition: None
  *
  * Input: None
  *
  * Output: None
  *
  ********************************************************************/
-static void LCD_ShiftCursorDown ( void )
+static void LCD_ClearShadow ( void )
 {
-    uint8_t i ;
+    uint8_t r ;
+    uint8_t c ;
 
-    for (i = 0 ; i < LCD_MAX_COLUMN ; i++)
+    for (r = 0 ; r < LCD_MAX_ROW ; r++)
     {
-        LCD_ShiftCursorRight ( ) ;
+        for (c = 0 ; c < LCD_MAX_COLUMN ; c++)
+        {
+            frameBuffer[r][c] = ' ' ;
+            screenShadow[r][c] = ' ' ;
+        }
     }
 }
 /*********************************************************************
@@ -407,6 +595,169 @@ static void LCD_Wait ( uint32_t delay )
         delay-- ;
     }
 }
+#if LCD_ASYNC
+/*********************************************************************
+ * Function: static void LCD_QueueInitialize(void)
+ *
+ * Overview: Sets up Timer4 which drains the output queue.  The timer is
+ *           only running while there are entries to send.
+ *
+ * PreCondition: None
+ *
+ * Input: None
+ *
+ * Output: None
+ *
+ ********************************************************************/
+static void LCD_QueueInitialize ( void )
+{
+    queueHead = 0 ;
+    queueTail = 0 ;
+    queueActive = false ;
+#if LCD_USE_BUSY_FLAG
+    queueTimeout = 0 ;
+#endif
+
+    T4CON = 0 ;
+    TMR4 = 0 ;
+    T4CONbits.TCKPS = 0b01 ;     // 1:8
+    IPC6bits.T4IP = LCD_INTERRUPT_PRIORITY ;
+    IFS1bits.T4IF = 0 ;
+    IEC1bits.T4IE = 1 ;
+}
+/*********************************************************************
+ * Function: static void LCD_Enqueue(uint16_t entry)
+ *
+ * Overview: Puts one byte with its flags into the output queue and starts
+ *           the Timer4 interrupt if it is idle.  When the queue is full it
+ *           waits for the interrupt to make room and counts an overflow, so
+ *           it must not be called from an interrupt of priority
+ *           LCD_INTERRUPT_PRIORITY or higher.
+ *
+ * PreCondition: LCD_QueueInitialize()
+ *
+ * Input: uint16_t - byte in bits 0-7, LCD_QUEUE_DATA/LCD_QUEUE_SLOW flags
+ *
+ * Output: None
+ *
+ ********************************************************************/
+static void LCD_Enqueue ( uint16_t entry )
+{
+    uint8_t next = ( queueHead + 1 ) & ( LCD_QUEUE_SIZE - 1 ) ;
+    uint8_t depth ;
+
+    if (next == queueTail)
+    {
+        queueOverflows++ ;
+        while (next == queueTail)
+        {
+        }
+    }
+
+    queue[queueHead] = entry ;
+    queueHead = next ;
+
+    depth = ( queueHead - queueTail ) & ( LCD_QUEUE_SIZE - 1 ) ;
+    if (depth > queueHighWater)
+    {
+        queueHighWater = depth ;
+    }
+
+    // The interrupt stops itself when it finds the queue empty, the check
+    // has to be done with it masked so a just added entry is not left behind
+    IEC1bits.T4IE = 0 ;
+    if (queueActive == false)
+    {
+        queueActive = true ;
+        IFS1bits.T4IF = 1 ;
+    }
+    IEC1bits.T4IE = 1 ;
+}
+/*********************************************************************
+ * Function: void _T4Interrupt(void)
+ *
+ * Overview: Fires when the settle time of the previously sent entry has
+ *           elapsed.  Services the queue and records its execution time.
+ *
+ * PreCondition: LCD_QueueInitialize()
+ *
+ * Input: None
+ *
+ * Output: None
+ *
+ ********************************************************************/
+void __attribute__((interrupt, no_auto_psv)) _T4Interrupt ( void )
+{
+    POMIAR_START ( ) ;
+
+    IFS1bits.T4IF = 0 ;
+    LCD_QueueService ( ) ;
+    POMIAR_KONIEC ( queueServiceTime ) ;
+}
+/*********************************************************************
+ * Function: static void LCD_QueueService(void)
+ *
+ * Overview: Sends the next entry and programs the timer with its settle
+ *           time, or stops the timer when the queue is empty.  With the
+ *           busy flag the timer fires after a short poll interval and is
+ *           re-armed until the flag clears or the settle time runs out.
+ *
+ * PreCondition: Called from _T4Interrupt only
+ *
+ * Input: None
+ *
+ * Output: None
+ *
+ ********************************************************************/
+static void LCD_QueueService ( void )
+{
+    uint16_t entry ;
+
+#if LCD_USE_BUSY_FLAG
+    if (queueTimeout != 0)
+    {
+        if (LCD_ReadStatus ( ) & LCD_STATUS_BUSY)
+        {
+            if (queueTimeout > PR4)
+            {
+                queueTimeout -= PR4 ;
+                TMR4 = 0 ;
+                return ;
+            }
+            busyFlagUsable = false ;
+        }
+        queueTimeout = 0 ;
+    }
+#endif
+
+    if (queueTail == queueHead)
+    {
+        T4CONbits.TON = 0 ;
+        queueActive = false ;
+        return ;
+    }
+
+    entry = queue[queueTail] ;
+    queueTail = ( queueTail + 1 ) & ( LCD_QUEUE_SIZE - 1 ) ;
+
+    PMADDR = ( entry & LCD_QUEUE_DATA ) ? 0x0001 : 0x0000 ;
+    HAL_PMP_ZAPIS ( entry & 0x00FF ) ;
+
+    TMR4 = 0 ;
+#if LCD_USE_BUSY_FLAG
+    if (busyFlagUsable == true)
+    {
+        queueTimeout = ( entry & LCD_QUEUE_SLOW ) ? LCD_S_TICKS : LCD_F_TICKS ;
+        PR4 = ( entry & LCD_QUEUE_SLOW ) ? LCD_S_POLL_TICKS : LCD_F_POLL_TICKS ;
+    }
+    else
+#endif
+    {
+        PR4 = ( entry & LCD_QUEUE_SLOW ) ? LCD_S_TICKS : LCD_F_TICKS ;
+    }
+    T4CONbits.TON = 1 ;
+}
+#endif
 /*********************************************************************
  * Function: void LCD_CursorEnable(bool enable)
  *
@@ -430,4 +781,66 @@ void LCD_CursorEnable ( bool enable )
         LCD_SendCommand ( LCD_COMMAND_CURSOR_OFF , LCD_F_INSTR ) ;
     }
 }
-
+/*********************************************************************
+ * Function: uint8_t LCD_GetQueueHighWater(void)
+ *
+ * Overview: Returns the largest number of entries that were waiting in the
+ *           output queue since startup.
+ *
+ * PreCondition: None
+ *
+ * Input: None
+ *
+ * Output: uint8_t - maximum queue depth, 0 in blocking mode
+ *
+ ********************************************************************/
+uint8_t LCD_GetQueueHighWater ( void )
+{
+#if LCD_ASYNC
+    return queueHighWater ;
+#else
+    return 0 ;
+#endif
+}
+/*********************************************************************
+ * Function: uint16_t LCD_GetQueueOverflows(void)
+ *
+ * Overview: Returns how many times a write found the output queue full and
+ *           had to wait for it to drain.
+ *
+ * PreCondition: None
+ *
+ * Input: None
+ *
+ * Output: uint16_t - number of overflows, 0 in blocking mode
+ *
+ ********************************************************************/
+uint16_t LCD_GetQueueOverflows ( void )
+{
+#if LCD_ASYNC
+    return queueOverflows ;
+#else
+    return 0 ;
+#endif
+}
+/*********************************************************************
+ * Function: uint16_t LCD_GetInterruptCycles(void)
+ *
+ * Overview: Returns the longest Timer4 interrupt since startup, measured
+ *           with the free running Timer5 (pomiar.h).
+ *
+ * PreCondition: pomiar_init()
+ *
+ * Input: None
+ *
+ * Output: uint16_t - worst case in Tcy, 0 in blocking mode
+ *
+ ********************************************************************/
+uint16_t LCD_GetInterruptCycles ( void )
+{
+#if LCD_ASYNC
+    return queueServiceTime.max ;
+#else
+    return 0 ;
+#endif
+}
\ No newline at end of file
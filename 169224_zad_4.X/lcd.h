@@ -17,6 +17,34 @@ limitations under the License.
 #include <stdint.h>
 #include <stdbool.h>
 
+/* Display geometry, selected at compile time by defining LCD_GEOMETRY.  All
+ * cursor moves use one DDRAM address command, so larger displays cost the
+ * same per operation. */
+#define LCD_GEOMETRY_16x2   0
+#define LCD_GEOMETRY_20x2   1
+#define LCD_GEOMETRY_20x4   2
+#define LCD_GEOMETRY_40x2   3
+
+#ifndef LCD_GEOMETRY
+#define LCD_GEOMETRY        LCD_GEOMETRY_16x2
+#endif
+
+#if LCD_GEOMETRY == LCD_GEOMETRY_16x2
+#define LCD_COLUMNS         16
+#define LCD_ROWS            2
+#elif LCD_GEOMETRY == LCD_GEOMETRY_20x2
+#define LCD_COLUMNS         20
+#define LCD_ROWS            2
+#elif LCD_GEOMETRY == LCD_GEOMETRY_20x4
+#define LCD_COLUMNS         20
+#define LCD_ROWS            4
+#elif LCD_GEOMETRY == LCD_GEOMETRY_40x2
+#define LCD_COLUMNS         40
+#define LCD_ROWS            2
+#else
+#error "Unsupported LCD_GEOMETRY"
+#endif
+
 /*********************************************************************
 * Function: bool LCD_Initialize(void);
 *
@@ -81,6 +109,55 @@ void LCD_PutChar(char);
 ********************************************************************/
 void LCD_ClearScreen(void);
 
+/*********************************************************************
+* Function: void LCD_SetCursor(uint8_t row, uint8_t column);
+*
+* Overview: Moves the cursor to the given position with a single DDRAM
+*           address command.  Positions outside the display are ignored.
+*
+* PreCondition: already initialized via LCD_Initialize()
+*
+* Input: uint8_t - row, 0 to LCD_ROWS - 1
+*        uint8_t - column, 0 to LCD_COLUMNS - 1
+*
+* Output: None
+*
+********************************************************************/
+void LCD_SetCursor(uint8_t row, uint8_t column);
+
+/*********************************************************************
+* Function: void LCD_WriteRow(uint8_t row, const char* text);
+*
+* Overview: Writes a row of text into the shadow frame buffer.  The text is
+*           truncated to the display width and padded with spaces.  Nothing
+*           is sent to the LCD until LCD_Flush() is called.
+*
+* PreCondition: already initialized via LCD_Initialize()
+*
+* Input: uint8_t - row to write, 0 to LCD_ROWS - 1
+*        const char* - null terminated text
+*
+* Output: None
+*
+********************************************************************/
+void LCD_WriteRow(uint8_t row, const char* text);
+
+/*********************************************************************
+* Function: void LCD_Flush(void);
+*
+* Overview: Sends to the LCD only the cells of the frame buffer that differ
+*           from what is currently displayed, repositioning the cursor with
+*           a single DDRAM address command where needed.
+*
+* PreCondition: already initialized via LCD_Initialize()
+*
+* Input: None
+*
+* Output: None
+*
+********************************************************************/
+void LCD_Flush(void);
+
 /*********************************************************************
 * Function: void LCD_CursorEnable(bool enable)
 *
@@ -93,4 +170,49 @@ void LCD_ClearScreen(void);
 * Output: None
 *
 ********************************************************************/
-void LCD_CursorEnable(bool enable);
\ No newline at end of file
+void LCD_CursorEnable(bool enable);
+
+/*********************************************************************
+* Function: uint8_t LCD_GetQueueHighWater(void)
+*
+* Overview: Returns the largest number of entries that were waiting in the
+*           output queue since startup.  Used to size LCD_QUEUE_SIZE.
+*
+* PreCondition: None
+*
+* Input: None
+*
+* Output: uint8_t - maximum queue depth, 0 in blocking mode
+*
+********************************************************************/
+uint8_t LCD_GetQueueHighWater(void);
+
+/*********************************************************************
+* Function: uint16_t LCD_GetQueueOverflows(void)
+*
+* Overview: Returns how many times a write found the output queue full and
+*           had to wait for it to drain.
+*
+* PreCondition: None
+*
+* Input: None
+*
+* Output: uint16_t - number of overflows, 0 in blocking mode
+*
+********************************************************************/
+uint16_t LCD_GetQueueOverflows(void);
+
+/*********************************************************************
+* Function: uint16_t LCD_GetInterruptCycles(void)
+*
+* Overview: Returns the longest Timer4 interrupt since startup, measured
+*           with the free running Timer5 (pomiar.h).
+*
+* PreCondition: pomiar_init()
+*
+* Input: None
+*
+* Output: uint16_t - worst case in Tcy, 0 in blocking mode
+*
+********************************************************************/
+uint16_t LCD_GetInterruptCycles(void);
\ No newline at end of file
@@ -19,80 +19,120 @@
 #pragma config GCP = OFF
 #pragma config JTAGEN = OFF
 
+#include "taktowanie.h"          // FCY i stale czasowe
 #include <stdio.h>
 #include <stdlib.h>
 #include <xc.h>
 #include <libpic30.h>
 #include "lcd.h"
-
-// Deklaracja zegara systemowego
-#define XTAL_FREQ 8000000
-#define FCY 4000000
+#include "zegary.h"             // zegary programowe na czas.h (Timer1-3)
+#include "praca.h"              // przyciski poza przerwaniem CN
+#include "przyciski.h"          // debouncing i autopowtarzanie przyciskow
+#include "pomiar.h"             // czasy przerwan na Timer5
+#include "automat.h"            // stany minutnika
 
 // DEKLARACJE FUNKCJI - DODANE
 void sprawdz_czas(void);
 void ustaw_urzadzenie(void);
 void pokaz_na_ekranie(void);
-void zatrzymaj(void);
-void zacznij(void);
+void uplynela_sekunda(void);
+void mignij(void);
+void uplynal_napis(void);
+void obudz_przyciski(uint16_t port, uint32_t chwila);
+void probkuj_przyciski(void);
+
+// Akcje i warunki automatu minutnika
+void zatrzymaj(automat_t *m, const automat_zdarzenie_t *z);
+void zacznij(automat_t *m, const automat_zdarzenie_t *z);
+void zakoncz_odliczanie(automat_t *m, const automat_zdarzenie_t *z);
+void pauza(automat_t *m, const automat_zdarzenie_t *z);
+void zakoncz_pauze(automat_t *m, const automat_zdarzenie_t *z);
+void pokaz_napis(automat_t *m, const automat_zdarzenie_t *z);
+void zdejmij_napis(automat_t *m, const automat_zdarzenie_t *z);
+void odlicz_sekunde(automat_t *m, const automat_zdarzenie_t *z);
+void dodaj_czas(automat_t *m, const automat_zdarzenie_t *z);
+uint8_t jest_czas(automat_t *m, const automat_zdarzenie_t *z);
+
+// Stany minutnika (automat.h) - liscie, potem stany nadrzedne
+#define STAN_STOP       0       // czas do ustawienia albo ustawiony
+#define STAN_DZIALA     1
+#define STAN_PAUZA      2
+#define STAN_GOTOWE     3       // po odliczeniu - "SMACZNEGO!" przez 5 s
+#define STAN_ZATRZYMANY 4       // nadrzedny STOP, PAUZA i GOTOWE - start
+#define STAN_MINUTNIK   5       // nadrzedny wszystkich - dodawanie czasu
+#define STANY           6
+
+// Zdarzenia minutnika
+#define Z_START_STOP    0       // RD13
+#define Z_DODAJ         1       // RD6 i RD7, argument - sekundy
+#define Z_SEKUNDA       2
+#define Z_KONIEC_CZASU  3
+#define Z_KONIEC_NAPISU 4
+#define ZDARZENIA       5
+
+// Zegary i ekran zmienia wejscie i wyjscie stanu, wiec start i pauza licza
+// terminy od chwili przejscia. Dodawanie czasu dziala w kazdym stanie,
+// w GOTOWE dodatkowo konczy napis
+static const automat_stan_t stany[STANY] = {
+    [STAN_STOP]       = { STAN_ZATRZYMANY, zatrzymaj, NULL },
+    [STAN_DZIALA]     = { STAN_MINUTNIK, zacznij, zakoncz_odliczanie },
+    [STAN_PAUZA]      = { STAN_ZATRZYMANY, pauza, zakoncz_pauze },
+    [STAN_GOTOWE]     = { STAN_ZATRZYMANY, pokaz_napis, zdejmij_napis },
+    [STAN_ZATRZYMANY] = { STAN_MINUTNIK, NULL, NULL },
+    [STAN_MINUTNIK]   = { AUTOMAT_BRAK, NULL, NULL },
+};
+
+static const automat_przejscie_t przejscia[STANY][ZDARZENIA] = {
+    [STAN_ZATRZYMANY][Z_START_STOP] = PRZEJSCIE(STAN_DZIALA, jest_czas, NULL),
+    [STAN_DZIALA][Z_START_STOP]     = PRZEJSCIE(STAN_PAUZA, NULL, NULL),
+    [STAN_DZIALA][Z_SEKUNDA]        = WEWNETRZNE(NULL, odlicz_sekunde),
+    [STAN_DZIALA][Z_KONIEC_CZASU]   = PRZEJSCIE(STAN_GOTOWE, NULL, NULL),
+    [STAN_GOTOWE][Z_KONIEC_NAPISU]  = PRZEJSCIE(STAN_STOP, NULL, NULL),
+    [STAN_GOTOWE][Z_DODAJ]          = PRZEJSCIE(STAN_STOP, NULL, dodaj_czas),
+    [STAN_MINUTNIK][Z_DODAJ]        = WEWNETRZNE(NULL, dodaj_czas),
+};
 
-// Zmienne globalne - volatile bo u?ywane w przerwaniach
-volatile uint16_t czas_sekundy = 0;           // ile sekund zostalo
-volatile uint8_t stan = 0;                    // 0=stop, 1=dziala, 2=pauza
+static const automat_opis_t opis_minutnika = {
+    stany, &przejscia[0][0], STANY, ZDARZENIA, STAN_STOP
+};
+
+// Zmienne globalne - czas i stan zmienia tylko petla glowna
+uint16_t czas_sekundy = 0;                    // ile sekund zostalo
+automat_t minutnik;                           // stan (STAN_...)
 volatile uint16_t odswiez_ekran = 1;          // czy odswiezyc wyswietlacz
 volatile uint16_t migaj = 0;                  // do migania dwukropka
-volatile uint16_t licznik_ms = 0;             // licznik milisekund
-volatile uint16_t ostatnia_sekunda = 0;       // kiedy ostatnio odliczylismy sekunde
-volatile uint16_t skonczyl = 0;               // czy skonczylo sie odliczanie
 
-// Przerwanie od Timer1 (1ms)
-void __attribute__((interrupt, auto_psv)) _T1Interrupt(void)
-{
-    IFS0bits.T1IF = 0;          // wyczysc flage przerwania
-    
-    licznik_ms++;               // zwieksz licznik milisekund
-    
-    // Co 500ms zmien miganie
-    if (licznik_ms % 500 == 0) {
-        migaj = !migaj;        
-    }
-}
+// Zegary programowe (zegary.h) - uruchamiane tylko w petli glownej
+zegar_t zegar_sekundy = ZEGAR(uplynela_sekunda);  // odliczanie, co 1 s
+zegar_t zegar_migania = ZEGAR(mignij);          // dwukropek w pauzie, co 500ms
+zegar_t zegar_napisu = ZEGAR(uplynal_napis);    // "SMACZNEGO!" przez 5 s
+zegar_t zegar_przyciskow = ZEGAR(probkuj_przyciski); // CN wylaczone do puszczenia
+
+#define SEKUNDA         CZAS_MS(1000)
+#define POL_SEKUNDY     CZAS_MS(500)
+#define CZAS_NAPISU     CZAS_MS(5000)
+#define PROBKOWANIE     CZAS_US(PRZYCISKI_OKRES_US)
+
+// Przyciski: RD6 (+1 min), RD7 (+10 s), RD13 (start/stop)
+#define MASKA_PRZYCISKOW ((1u << 6) | (1u << 7) | (1u << 13))
+
+przyciski_t przyciski;          // tylko petla glowna (probkuj_przyciski)
+
+// Czas wykonania przerwania CN (pomiar.h) - do podgladu w debuggerze
+pomiar_t pomiar_cn;
 
-// Przerwanie Change Notification - obsluga przyciskow
+// Przerwanie Change Notification - gorna polowa: tylko budzi probkowanie
+// przyciskow (praca.h), CN wylaczone, az przyciski beda puszczone. Czas
+// i stan zmienia petla glowna (probkuj_przyciski i automat)
 void __attribute__((interrupt, no_auto_psv)) _CNInterrupt(void) {
-    __delay32(FCY/100);  // POPRAWIONE - debouncing 10ms
-    
-    // Przycisk +1min (RD6/CN15)
-    if(PORTDbits.RD6 == 0) {
-        czas_sekundy += 60;     // dodaj 60 sekund = 1 min
-        if (czas_sekundy > 5999) czas_sekundy = 5999; // max 99:59
-        odswiez_ekran = 1;      // odswiez ekran
-    }
-    
-    // Przycisk +10sec (RD7/CN16) 
-    else if(PORTDbits.RD7 == 0) {
-        czas_sekundy += 10;     // dodaj 10 sekund
-        if (czas_sekundy > 5999) czas_sekundy = 5999; // max 99:59
-        odswiez_ekran = 1;      // odswiez ekran
-    }
-    
-    // Przycisk Start/Stop (RD13/CN19)
-    else if(PORTDbits.RD13 == 0) {
-        if (stan == 0 || stan == 2) {      // jesli zatrzymana lub pauza
-            if (czas_sekundy > 0) {         // jesli jest czas do odliczenia
-                zacznij();                  // zacznij odliczanie
-            }
-        } else if (stan == 1) {             // jesli dziala
-            stan = 2;                       // ustaw na pauze
-            odswiez_ekran = 1;             // odswiez ekran
-        }
-    }
+    POMIAR_START();
     
-    // Czekaj na zwolnienie przyciskw
-    while(PORTDbits.RD6 == 0 || PORTDbits.RD7 == 0 || PORTDbits.RD13 == 0);
+    praca_zglos(obudz_przyciski, PORTD, czas_teraz());
+    IEC1bits.CNIE = 0;
     
     // Wyczysc flage przerwania
     IFS1bits.CNIF = 0;
+    POMIAR_KONIEC(pomiar_cn);
 }
 
 int main(void) 
@@ -103,44 +143,111 @@ int main(void)
         sprawdz_czas();         // sprawdz czy minela sekunda
         
         if (odswiez_ekran) {    // jesli trzeba odswiezyc
-            pokaz_na_ekranie();  // pokaz aktualny stan
             odswiez_ekran = 0; 
+            pokaz_na_ekranie();  // pokaz aktualny stan
         }
         
-        // Automatyczne resetowanie po 5 sekundach od zako?czenia
-        static uint16_t czas_gotowe = 0;
-        if (czas_sekundy == 0 && stan == 0 && skonczyl) {
-            czas_gotowe++;
-            if (czas_gotowe > 5000) {  // po 5 sekundach (5000ms)
-                skonczyl = 0;
-                czas_gotowe = 0;
-                odswiez_ekran = 1;
-            }
-        } else {
-            czas_gotowe = 0;
+        // Spij do najblizszego terminu albo przycisku. IPL 7 - przerwanie
+        // miedzy sprawdzeniem a Idle() obudzi procesor zaraz po Idle()
+        SRbits.IPL = 7;
+        if (!odswiez_ekran && !praca_czeka()) {
+            zegary_budzik();
+            Idle();
         }
+        SRbits.IPL = 0;
     }
     
     return 0;
 }
 
-// Sprawdza czy minela sekunda i odlicza czas
-void sprawdz_czas(void) 
+// Dolna polowa przerwania CN - probki przyciskow co PROBKOWANIE, dopoki
+// nie beda puszczone. Drgania liczy przyciski.h, nie blokada CN
+void obudz_przyciski(uint16_t port, uint32_t chwila) 
 {
-    // Jesli kuchenka dziala i jest czas do odliczenia
-    if (stan == 1 && czas_sekundy > 0) {
-        // Jesli minelo 1000ms (1 sekunda)
-        if (licznik_ms - ostatnia_sekunda >= 1000) {
-            czas_sekundy--;                 // odlicz sekunde
-            ostatnia_sekunda = licznik_ms;  // zapamietaj kiedy
-            odswiez_ekran = 1;             // odswiez ekran
-            
-            // Jesli czas sie skonczyl
-            if (czas_sekundy == 0) {
-                zatrzymaj();                // zatrzymaj kuchenke
-            }
+    if (!zegar_przyciskow.aktywny) {
+        zegar_start(&zegar_przyciskow, PROBKOWANIE, PROBKOWANIE);
+    }
+}
+
+// Probka przyciskow, wcisniecia to zdarzenia automatu. Trzymane +1min
+// i +10sec powtarzaja sie coraz szybciej (przyciski.h), wiec czas przewija
+// sie bez wciskania w kolko
+void probkuj_przyciski(void) 
+{
+    przyciski_zdarzenia_t z;
+    uint16_t dodawanie;
+    
+    if (przyciski_probka(&przyciski, PORTD, &z)) {
+        dodawanie = z.wcisniete | z.powtorzenia;
+        if (dodawanie & (1u << 6)) {                // +1min (RD6/CN15)
+            automat_wyslij(&minutnik, Z_DODAJ, 60, 0);
+        } else if (dodawanie & (1u << 7)) {         // +10sec (RD7/CN16)
+            automat_wyslij(&minutnik, Z_DODAJ, 10, 0);
+        } else if (z.wcisniete & (1u << 13)) {      // Start/Stop (RD13/CN19)
+            automat_wyslij(&minutnik, Z_START_STOP, 0, 0);
         }
     }
+    
+    // Puszczone i ustalone - koniec probkowania, znowu czekanie na CN
+    if (przyciski_spokoj(&przyciski)) {
+        zegar_stop(&zegar_przyciskow);
+        IFS1bits.CNIF = 0;
+        IEC1bits.CNIE = 1;
+    }
+}
+
+// Przyciski z przerwania CN i zegary, ktorych czas minal
+void sprawdz_czas(void) 
+{
+    praca_obsluz();             // przyciski z przerwania CN
+    zegary_obsluz();            // wywoluje akcje ponizej
+}
+
+// Zegary tylko wysylaja zdarzenia - co z nimi zrobic, wie automat
+void uplynela_sekunda(void) 
+{
+    automat_wyslij(&minutnik, Z_SEKUNDA, 0, 0);
+}
+
+void uplynal_napis(void) 
+{
+    automat_wyslij(&minutnik, Z_KONIEC_NAPISU, 0, 0);
+}
+
+// W pauzie zmien miganie
+void mignij(void) 
+{
+    migaj = !migaj;
+    odswiez_ekran = 1;
+}
+
+// Kolejna sekunda odliczania (tylko w STAN_DZIALA). Zegar okresowy liczy
+// termin od poprzedniego, wiec nie ma dryfu, a po dlugim przerwaniu
+// zalegle sekundy przychodza po kolei
+void odlicz_sekunde(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    czas_sekundy--;                     // odlicz sekunde
+    odswiez_ekran = 1;                 // odswiez ekran
+    
+    // Jesli czas sie skonczyl - po tym przejsciu
+    if (czas_sekundy == 0) {
+        automat_wyslij(m, Z_KONIEC_CZASU, 0, 0);
+    }
+}
+
+// +1min i +10sec, najwyzej 99:59
+void dodaj_czas(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    uint16_t dodaj = z->argument;
+    
+    czas_sekundy = (dodaj > 5999 - czas_sekundy) ? 5999 : czas_sekundy + dodaj;
+    odswiez_ekran = 1;
+}
+
+// Start tylko, gdy jest czas do odliczenia
+uint8_t jest_czas(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    return czas_sekundy > 0;
 }
 
 // Inicjalizacja urzadzenia
@@ -160,6 +267,7 @@ void ustaw_urzadzenie(void)
     CNEN1bits.CN15IE = 1;       // Wlacz przerwanie dla RD6
     CNEN2bits.CN16IE = 1;       // Wlacz przerwanie dla RD7
     CNEN2bits.CN19IE = 1;       // Wlacz przerwanie dla RD13
+    przyciski_init(&przyciski, MASKA_PRZYCISKOW);
     
     IFS1bits.CNIF = 0;          // Wyczysc flage przerwania CN
     IEC1bits.CNIE = 1;          // Wlacz przerwania CN
@@ -168,78 +276,101 @@ void ustaw_urzadzenie(void)
     LCD_Initialize();
     LCD_ClearScreen();
     
-    // Ustaw timer na 1ms
-    T1CON = 0;                  // wyczysc ustawienia timera
-    TMR1 = 0;                   // wyczysc licznik
-    PR1 = FCY/1000 - 1;         // POPRAWIONE - ustaw na 1ms
-    T1CONbits.TCKPS = 0b00;     // bez dzielnika
-    IPC0bits.T1IP = 3;          // priorytet 3 (nizszy niz CN)
-    IFS0bits.T1IF = 0;          // wyczysc flage
-    IEC0bits.T1IE = 1;          // wlacz przerwanie
-    T1CONbits.TON = 1;          // wlacz timer
+    // Podstawa czasu (Timer2/3), budzik (Timer1, priorytet nizszy niz CN),
+    // zegary programowe i czasy przerwan (Timer5)
+    czas_init();
+    zegary_init();
+    pomiar_init();
+    automat_init(&minutnik, &opis_minutnika, 0);    // STAN_STOP
     
     // Tekst poczatkowy
-    LCD_PutString("GOTOWE ZA:", 10);
-    LCD_PutChar('\n');         
-    LCD_PutString("Czas: 00:00", 11);
+    LCD_WriteRow(0, "GOTOWE ZA:");
+    LCD_WriteRow(1, "Czas: 00:00");
+    LCD_Flush();
     
     // W??cz przerwania globalne
     INTCON1bits.NSTDIS = 0;
 }
 
 // Pokazuje aktualny stan na wyswietlaczu
+// Wiersze trafiaja do bufora LCD, a LCD_Flush wysyla tylko zmienione znaki
 void pokaz_na_ekranie(void) 
 {
     char tekst[17];                   
     uint16_t minuty = czas_sekundy / 60;     // ile minut
     uint16_t sekundy = czas_sekundy % 60;    // ile sekund
     
-    LCD_ClearScreen();
-    
-    if (stan == 0) {                    // zatrzymana
-        if (czas_sekundy == 0) {
-            if (skonczyl) {             // po zakonczeniu gotowania
-                LCD_PutString("GOTOWE", 6);
-            } else {                    // stan poczatkowy
-                LCD_PutString("GOTOWE ZA:", 10); 
-            }
-        } else {
-            LCD_PutString("GOTOWE ZA:", 10);  // ustawiono czas, ale nie wystartowano
-        }
-    } else if (stan == 1) {             // dziala
-        LCD_PutString("Pracuje", 7);
-        skonczyl = 1;                   
-    } else if (stan == 2) {             // pauza
-        LCD_PutString("Pauza", 5);
+    switch (minutnik.stan) {
+        case STAN_STOP:                 // zatrzymana, czas do ustawienia
+            LCD_WriteRow(0, "GOTOWE ZA:");
+            break;
+        case STAN_DZIALA:
+            LCD_WriteRow(0, "Pracuje");
+            break;
+        case STAN_PAUZA:
+            LCD_WriteRow(0, "Pauza");
+            break;
+        case STAN_GOTOWE:               // po zakonczeniu gotowania
+            LCD_WriteRow(0, "GOTOWE");
+            break;
     }
     
-    LCD_PutChar('\n');
-    
     // Drugi wiersz
-    if (stan == 0 && czas_sekundy == 0 && skonczyl) {
-        LCD_PutString("SMACZNEGO!", 10);
+    if (minutnik.stan == STAN_GOTOWE) {
+        LCD_WriteRow(1, "SMACZNEGO!");
     } else {
         // W trybie pauzy migaj dwukropkiem
-        if (stan == 2 && migaj) {
+        if (minutnik.stan == STAN_PAUZA && migaj) {
             sprintf(tekst, "Czas: %02d %02d", minuty, sekundy);
         } else {
             sprintf(tekst, "Czas: %02d:%02d", minuty, sekundy);
         }
-        LCD_PutString(tekst, 11);
+        LCD_WriteRow(1, tekst);
     }
+    
+    LCD_Flush();
 }
 
-// Zatrzymanie odliczania
-void zatrzymaj(void) 
+// Zatrzymana - czas do ustawienia
+void zatrzymaj(automat_t *m, const automat_zdarzenie_t *z) 
 {
-    stan = 0;                   // ustaw stan na zatrzymana
     odswiez_ekran = 1;         // odswiez ekran
 }
 
-// Zaczyna odliczanie
-void zacznij(void) 
+// Zaczyna odliczanie - sekunda liczy sie od teraz
+void zacznij(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    zegar_start(&zegar_sekundy, SEKUNDA, SEKUNDA);
+    odswiez_ekran = 1;                 // odswiez ekran
+}
+
+void zakoncz_odliczanie(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    zegar_stop(&zegar_sekundy);
+}
+
+// Wstrzymuje odliczanie - miganie od teraz
+void pauza(automat_t *m, const automat_zdarzenie_t *z) 
 {
-    stan = 1;                           // stan - dziala
-    ostatnia_sekunda = licznik_ms;      // zapamietaj czas startu
+    migaj = 0;
+    zegar_start(&zegar_migania, POL_SEKUNDY, POL_SEKUNDY);
     odswiez_ekran = 1;                 // odswiez ekran
-}
\ No newline at end of file
+}
+
+void zakoncz_pauze(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    zegar_stop(&zegar_migania);
+}
+
+// Koniec odliczania - napis przez CZAS_NAPISU
+void pokaz_napis(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    zegar_start(&zegar_napisu, CZAS_NAPISU, 0);
+    odswiez_ekran = 1;
+}
+
+void zdejmij_napis(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    zegar_stop(&zegar_napisu);
+    odswiez_ekran = 1;
+}
@@ -19,149 +19,192 @@
 #pragma config GCP = OFF
 #pragma config JTAGEN = OFF
 
+#include "taktowanie.h"          // FCY i stale czasowe
 #include <stdio.h>
 #include <stdlib.h>
 #include <xc.h>
 #include <libpic30.h>
 #include <string.h>
 #include "lcd.h"
-
-// Deklaracja zegara systemowego
-#define XTAL_FREQ 8000000
-#define FCY 4000000
+#include "zegary.h"             // zegary programowe na czas.h (Timer1-3)
+#include "wybor.h"              // wybor czasu potencjometrem (ADC w tle)
+#include "praca.h"              // przyciski poza przerwaniem CN
+#include "przyciski.h"          // debouncing przyciskow graczy
+#include "pomiar.h"             // czasy przerwan na Timer5
+#include "automat.h"            // stany gry
 
 // DEKLARACJE FUNKCJI
-void init_adc(void);
-void czytaj_potencjometr(void);
 void ustaw_urzadzenie(void);
 void sprawdz_czas(void);
 void pokaz_na_ekranie(void);
-void resetuj_gre(void);
+void odlicz_sekunde(void);
+void obsluz_ruch(uint8_t gracz, czas_t chwila);
+void obsluz_zbocze(uint16_t port, uint32_t chwila);
+void probkuj_przyciski(void);
+void ustaw_czasy(void);
+
+// Akcje i warunki automatu gry
+void resetuj_gre(automat_t *m, const automat_zdarzenie_t *z);
+void zacznij_gre(automat_t *m, const automat_zdarzenie_t *z);
+void zakoncz_gre(automat_t *m, const automat_zdarzenie_t *z);
+void pokaz_wynik(automat_t *m, const automat_zdarzenie_t *z);
+void zmien_ture(automat_t *m, const automat_zdarzenie_t *z);
+uint8_t konczy_ruch(automat_t *m, const automat_zdarzenie_t *z);
 
-// Stany gry
+// Stany gry (automat.h)
 #define STAN_WYBOR_CZASU 0      // wybieranie czasu gry
-#define STAN_GRACZ1 1           // odmierza czas gracza 1
-#define STAN_GRACZ2 2           // odmierza czas gracza 2  
-#define STAN_KONIEC 4           // koniec gry
-
-// Czasy gry (w sekundach)
-uint16_t czasy_opcje[] = {300, 180, 60}; // 5min, 3min, 1min
-uint8_t opcje_ilosc = 3;
-char* nazwy_czasow[] = {"5 min", "3 min", "1 min"};
-
-// Zmienne globalne
-volatile uint16_t czas_gracz1 = 0;      // czas pozostaly graczowi 1 (sekundy)
-volatile uint16_t czas_gracz2 = 0;      // czas pozostaly graczowi 2 (sekundy)
-volatile uint8_t stan_gry = STAN_WYBOR_CZASU;
-volatile uint8_t aktywny_gracz = 1;     // 1 lub 2
-volatile uint8_t wybrana_opcja = 1;     // domyslnie 3 min
+#define STAN_GRA 1              // odmierza czas aktywnego gracza
+#define STAN_KONIEC 2           // koniec gry
+#define STANY 3
+
+// Zdarzenia gry - argument to gracz, chwila - nacisniecie albo koniec czasu
+#define Z_RUCH          0
+#define Z_CZAS_MINAL    1
+#define ZDARZENIA       2
+
+// Wejscie w wybor czasu resetuje gre, wejscie w gre zaczyna pierwsza ture
+// od chwili nacisniecia, wyjscie z gry zatrzymuje odliczanie
+static const automat_stan_t stany_gry[STANY] = {
+    [STAN_WYBOR_CZASU] = { AUTOMAT_BRAK, resetuj_gre, NULL },
+    [STAN_GRA]         = { AUTOMAT_BRAK, zacznij_gre, zakoncz_gre },
+    [STAN_KONIEC]      = { AUTOMAT_BRAK, pokaz_wynik, NULL },
+};
+
+static const automat_przejscie_t przejscia_gry[STANY][ZDARZENIA] = {
+    [STAN_WYBOR_CZASU][Z_RUCH] = PRZEJSCIE(STAN_GRA, NULL, NULL),
+    [STAN_GRA][Z_RUCH]         = WEWNETRZNE(konczy_ruch, zmien_ture),
+    [STAN_GRA][Z_CZAS_MINAL]   = PRZEJSCIE(STAN_KONIEC, NULL, NULL),
+    [STAN_KONIEC][Z_RUCH]      = PRZEJSCIE(STAN_WYBOR_CZASU, NULL, NULL),
+};
+
+static const automat_opis_t opis_gry = {
+    stany_gry, &przejscia_gry[0][0], STANY, ZDARZENIA, STAN_WYBOR_CZASU
+};
+
+// Przyciski graczy: bit PORTD i wejscie CN, kolejnosc w tablicy to numery
+// graczy. Przyciski Explorer16 z CN: S3 (RD6, CN15), S6 (RD7, CN16),
+// S4 (RD13, CN19) - np. {7, 16} jako trzeci gracz
+typedef struct {
+    uint8_t bit;                // RDx
+    uint8_t cn;                 // CNx
+} przycisk_t;
+
+const przycisk_t przyciski[] = {
+    {6,  15},                   // gracz 1 - S3
+    {13, 19},                   // gracz 2 - S4
+};
+#define LICZBA_GRACZY (sizeof(przyciski) / sizeof(przyciski[0]))
+#define BIT_IC6 13              // RD13 - jedyny przycisk z wejsciem IC (IC6)
+
+// Kolejnosc tur
+#define KOLEJNOSC_PO_KOLEI   0  // ruch oddaje czas nastepnemu z tablicy
+#define KOLEJNOSC_NACISNIETY 1  // czas przejmuje ten, kto nacisnal swoj przycisk
+#ifndef KOLEJNOSC
+#define KOLEJNOSC KOLEJNOSC_PO_KOLEI
+#endif
+
+// Tryby dodawania czasu po ruchu
+#define TRYB_BEZ        0       // sam czas gry
+#define TRYB_FISCHER    1       // +dodatek po kazdym ruchu
+#define TRYB_BRONSTEIN  2       // zwrot zuzytego czasu, najwyzej dodatek
+#define TRYB_US         3       // czas rusza dopiero po dodatku (opoznienie)
+
+typedef struct {
+    uint16_t czas_s;            // czas gry
+    uint8_t tryb;               // TRYB_...
+    uint8_t dodatek_s;          // inkrement albo opoznienie
+    const char *nazwa;          // najwyzej 10 znakow ("-> nazwa <-")
+} opcja_czasu_t;
+
+// Opcje czasu gry - galka w lewo 5 min, w prawo 1 min
+const opcja_czasu_t czasy_opcje[] = {
+    {300, TRYB_BEZ,       0, "5 min"},
+    {180, TRYB_FISCHER,   2, "3+2 Fisch"},
+    {180, TRYB_BEZ,       0, "3 min"},
+    {180, TRYB_BRONSTEIN, 2, "3 Bron 2s"},
+    {60,  TRYB_US,        3, "1 US 3s"},
+    {60,  TRYB_BEZ,       0, "1 min"},
+};
+#define OPCJE_ILOSC (sizeof(czasy_opcje) / sizeof(czasy_opcje[0]))
+#define OPCJA_DOMYSLNA 2        // 3 min
+
+#define SEKUNDA         ((int32_t)CZAS_MS(1000))
+#define DZIESIATA       ((int32_t)CZAS_MS(100))
+#define PROG_DZIESIATYCH (10 * SEKUNDA)        // ponizej - dziesiate i 10 Hz
+#define PROBKOWANIE     CZAS_US(PRZYCISKI_OKRES_US)
+
+// Zmienne globalne - stan gry zmienia tylko petla glowna. Gracze to
+// indeksy tablic, praca na ruch i na odswiezenie nie zalezy od ich liczby
+int32_t czas_gracza[LICZBA_GRACZY];     // pozostaly czas (impulsy czas.h),
+                                        // aktywnego - na chwile poczatek_tury
+czas_t poczatek_tury;                   // chwila nacisniecia, ktora zaczela ture
+const opcja_czasu_t *gra;               // opcja biezacej gry
+automat_t partia;                       // stan gry (STAN_...)
+uint8_t aktywny = 0;                    // gracz, ktoremu ubywa czasu
 volatile uint16_t odswiez_ekran = 1;
-volatile uint16_t licznik_ms = 0;
-volatile uint16_t ostatnia_sekunda = 0;
-volatile uint8_t zwyciezca = 0;         // 1 lub 2 - kto wygral
+uint8_t przegrany = 0;                  // komu skonczyl sie czas
 
-// ADC dla potencjometru
-volatile uint16_t wartosc_potencjometru = 0;
+// Dekodowanie przyciskow z migawki portu (z tablicy przyciski[])
+uint16_t maska_przyciskow;              // bity PORTD wszystkich przyciskow
+uint8_t gracz_bitu[16];                 // gracz dla bitu PORTD
 
-// Funkcja przerwania timera
-void __attribute__((interrupt, auto_psv)) _T1Interrupt(void)
-{
-    IFS0bits.T1IF = 0;
-    licznik_ms++;
-    
-    // Odczyt potencjometru co 100ms
-    if (licznik_ms % 100 == 0 && stan_gry == STAN_WYBOR_CZASU) {
-        czytaj_potencjometr();
-    }
-}
+// Debouncing (przyciski.h) i pierwsze zbocze kazdego wciskanego przycisku -
+// ruch liczy sie od zbocza, choc potwierdza go dopiero debouncing
+przyciski_t stan_przyciskow;
+czas_t zbocze_bitu[16];                 // chwila pierwszego zbocza bitu
+uint16_t zbocza;                        // bity z zapisanym zboczem
 
-// Przerwanie Change Notification - obsluga przyciskow
-void __attribute__((interrupt, no_auto_psv)) _CNInterrupt(void) {
-    __delay32(FCY/100);  // debouncing 10ms
+// Zegary programowe (zegary.h) - uruchamiane tylko w petli glownej
+zegar_t zegar_sekundy = ZEGAR(odlicz_sekunde);  // zmiana wyniku aktywnego gracza
+zegar_t zegar_przyciskow = ZEGAR(probkuj_przyciski); // probki do puszczenia
+
+// Czas wykonania przerwania CN (pomiar.h) - do podgladu w debuggerze
+pomiar_t pomiar_cn;
+
+// Najstarsze zbocze z bufora IC6 mlodsze niz debouncing - wczesniejsze
+// wpisy to drgania po poprzednim puszczeniu, a pozniejsze niz teraz (chwila
+// przerwania) wychodza jako bardzo stare. IC6 zatrzaskuje TMR2, czyli
+// mlodsze slowo czas_teraz(), wiec roznica 16-bit to wiek zbocza
+static czas_t zbocze_ic6(czas_t teraz) {
+    czas_t chwila = teraz;
+    uint8_t jest = 0;
     
-    // Przycisk gracza 1 (RD6)
-    if(PORTDbits.RD6 == 0) {
-        if (stan_gry == STAN_GRACZ1) {
-            // Gracz 1 skonczyl ruch - teraz kolej gracza 2
-            stan_gry = STAN_GRACZ2;
-            aktywny_gracz = 2;
-            ostatnia_sekunda = licznik_ms;
-            odswiez_ekran = 1;
-        }
-        // START GRY: Gracz 1 startuje czas graczowi 2
-        else if (stan_gry == STAN_WYBOR_CZASU) {
-            czas_gracz1 = czasy_opcje[wybrana_opcja];
-            czas_gracz2 = czasy_opcje[wybrana_opcja];
-            stan_gry = STAN_GRACZ2;
-            aktywny_gracz = 2;
-            ostatnia_sekunda = licznik_ms;
-            odswiez_ekran = 1;
-        }
-        // RESTART PO KONCU GRY
-        else if (stan_gry == STAN_KONIEC) {
-            resetuj_gre();
+    while (IC6CONbits.ICBNE) {
+        uint16_t wiek = (uint16_t)teraz - IC6BUF;
+        if (!jest && wiek <= CZAS_MS(DEBOUNCE_MS)) {
+            chwila = teraz - wiek;
+            jest = 1;
         }
     }
-    
-    // Przycisk gracza 2 (RD13)
-    else if(PORTDbits.RD13 == 0) {
-        if (stan_gry == STAN_GRACZ2) {
-            // Gracz 2 skonczyl ruch - teraz kolej gracza 1
-            stan_gry = STAN_GRACZ1;
-            aktywny_gracz = 1;
-            ostatnia_sekunda = licznik_ms;
-            odswiez_ekran = 1;
-        }
-        // START GRY: Gracz 2 startuje czas graczowi 1
-        else if (stan_gry == STAN_WYBOR_CZASU) {
-            czas_gracz1 = czasy_opcje[wybrana_opcja];
-            czas_gracz2 = czasy_opcje[wybrana_opcja];
-            stan_gry = STAN_GRACZ1;
-            aktywny_gracz = 1;
-            ostatnia_sekunda = licznik_ms;
-            odswiez_ekran = 1;
-        }
-        // RESTART PO KONCU GRY
-        else if (stan_gry == STAN_KONIEC) {
-            resetuj_gre();
-        }
+    // Przepelniony bufor - od nowa, zeby nie gubic nastepnych zboczy
+    if (IC6CONbits.ICOV) {
+        IC6CONbits.ICM = 0b000;
+        IC6CONbits.ICM = 0b010;
     }
-    
-    // Czekaj na zwolnienie przyciskow
-    while(PORTDbits.RD6 == 0 || PORTDbits.RD13 == 0);
-    
-    // Wyczysc flage przerwania
-    IFS1bits.CNIF = 0;
+    return chwila;
 }
 
-// Inicjalizacja ADC
-void init_adc(void) 
-{
-    AD1PCFGbits.PCFG5 = 0;    // AN5 jako wejscie analogowe
-    AD1CON1 = 0x00E0;         
-    AD1CON2 = 0;
-    AD1CON3 = 0x1F3F;         
-    AD1CHS = 5;               // Kanal AN5
-    AD1CON1bits.ADON = 1;     // Wlacz ADC
+// Numer najnizszego ustawionego bitu (x != 0) - mnozenie przez ciag
+// de Bruijna 0x09AF zamiast petli po bitach
+static const uint8_t debruijn[16] = {
+    0, 1, 2, 5, 3, 9, 6, 11, 15, 4, 8, 10, 14, 7, 13, 12
+};
+
+static uint8_t najnizszy_bit(uint16_t x) {
+    return debruijn[(uint16_t)((x & -x) * 0x09AFu) >> 12];
 }
 
-// Odczyt potencjometru
-void czytaj_potencjometr(void) 
-{
-    AD1CON1bits.SAMP = 1;
-    __delay32(100);
-    AD1CON1bits.SAMP = 0;
-    while (!AD1CON1bits.DONE);
-    wartosc_potencjometru = ADC1BUF0;
+// Przerwanie Change Notification - gorna polowa: migawka portu i chwila
+// wejscia do kolejki (praca.h). CN zostaje wlaczone - kazde zbocze ma swoja
+// chwile, a drgania odsiewa dopiero probkowanie w petli glownej
+void __attribute__((interrupt, no_auto_psv)) _CNInterrupt(void) {
+    POMIAR_START();
     
-    // Przelicz na opcje czasu (3 opcje)
-    uint8_t nowa_opcja = (wartosc_potencjometru * opcje_ilosc) / 1024;
-    if (nowa_opcja >= opcje_ilosc) nowa_opcja = opcje_ilosc - 1;
+    praca_zglos(obsluz_zbocze, PORTD, czas_teraz());
     
-    if (nowa_opcja != wybrana_opcja) {
-        wybrana_opcja = nowa_opcja;
-        odswiez_ekran = 1;
-    }
+    // Wyczysc flage przerwania
+    IFS1bits.CNIF = 0;
+    POMIAR_KONIEC(pomiar_cn);
 }
 
 int main(void) 
@@ -172,11 +215,22 @@ int main(void)
         sprawdz_czas();
         
         if (odswiez_ekran) {
-            pokaz_na_ekranie();
             odswiez_ekran = 0;
+            pokaz_na_ekranie();
         }
         
-        __delay32(1000);
+        // Spij do najblizszego terminu albo przycisku (IPL 7 - bez wyscigu
+        // z przerwaniem tuz przed Idle). Nowy wybor czasu tez przy IPL 7,
+        // bo ustawia go przerwanie ADC
+        SRbits.IPL = 7;
+        if (wybor_zmiana()) {
+            odswiez_ekran = 1;
+        }
+        if (!odswiez_ekran && !praca_czeka()) {
+            zegary_budzik();
+            Idle();
+        }
+        SRbits.IPL = 0;
     }
     
     return 0;
@@ -185,6 +239,8 @@ int main(void)
 // Inicjalizacja urzadzenia
 void ustaw_urzadzenie(void) 
 {
+    uint8_t i;
+    
     // Konfiguracja ADC - wszystkie cyfrowe oprocz AN5
     AD1PCFG = 0xFFDF;           
     TRISBbits.TRISB5 = 1;       // RB5/AN5 jako wejscie analogowe
@@ -193,13 +249,22 @@ void ustaw_urzadzenie(void)
     TRISA = 0x0000;             // Port A jako wyjscie (dla LCD)
     TRISD = 0xFFFF;             // Port D jako wejscie (przyciski)
     
-    // Konfiguracja Change Notification interrupts
-    CNPU1bits.CN15PUE = 1;      // Pull-up dla RD6 (gracz 1)
-    CNPU2bits.CN19PUE = 1;      // Pull-up dla RD13 (gracz 2)
+    // Przyciski z tablicy: pull-up, przerwanie CN i dekodowanie bitow
+    for (i = 0; i < LICZBA_GRACZY; i++) {
+        uint8_t cn = przyciski[i].cn;
+        
+        maska_przyciskow |= 1u << przyciski[i].bit;
+        gracz_bitu[przyciski[i].bit] = i;
+        if (cn < 16) {
+            CNPU1 |= 1u << cn;
+            CNEN1 |= 1u << cn;
+        } else {
+            CNPU2 |= 1u << (cn - 16);
+            CNEN2 |= 1u << (cn - 16);
+        }
+    }
     
-    // Wlaczenie przerwan Change Notification
-    CNEN1bits.CN15IE = 1;       // Wlacz przerwanie dla RD6
-    CNEN2bits.CN19IE = 1;       // Wlacz przerwanie dla RD13
+    przyciski_init(&stan_przyciskow, maska_przyciskow);
     
     IFS1bits.CNIF = 0;          // Wyczysc flage przerwania CN
     IEC1bits.CNIE = 1;          // Wlacz przerwania CN
@@ -208,109 +273,306 @@ void ustaw_urzadzenie(void)
     LCD_Initialize();
     LCD_ClearScreen();
     
-    // Konfiguracja timera na 1ms
-    T1CON = 0;
-    TMR1 = 0;
-    PR1 = FCY/1000 - 1;         // 1ms
-    T1CONbits.TCKPS = 0b00;     
-    IPC0bits.T1IP = 3;          // Priorytet przerwania 
-    IFS0bits.T1IF = 0;
-    IEC0bits.T1IE = 1;
-    T1CONbits.TON = 1;
+    // Podstawa czasu (Timer2/3), budzik (Timer1) i zegary programowe
+    czas_init();
+    zegary_init();
+    pomiar_init();              // czasy przerwan (Timer5)
+    
+    // Input Capture 6 (RD13) - zatrzask TMR2 na opadajacym zboczu, bez
+    // przerwania (bufor czyta obsluga przycisku)
+    if (maska_przyciskow & (1u << BIT_IC6)) {
+        IC6CON = 0;
+        IC6CONbits.ICTMR = 1;   // TMR2 - mlodsze slowo podstawy czasu
+        IC6CONbits.ICM = 0b010; // kazde opadajace zbocze
+    }
     
-    // Inicjalizacja ADC
-    init_adc();
+    // Wybor czasu - ADC mierzy w tle od razu, gra zaczyna sie od wyboru
+    wybor_init(OPCJE_ILOSC, OPCJA_DOMYSLNA);
     
     // Wlacz przerwania globalne
     INTCON1bits.NSTDIS = 0;
     
-    // domyslne czasy
-    czas_gracz1 = czasy_opcje[wybrana_opcja];
-    czas_gracz2 = czasy_opcje[wybrana_opcja];
+    // STAN_WYBOR_CZASU - domyslne czasy i start wyboru
+    automat_init(&partia, &opis_gry, 0);
+}
+
+// Czas wybranej opcji dla wszystkich graczy (raz na gre)
+void ustaw_czasy(void) 
+{
+    uint8_t i;
+    
+    gra = &czasy_opcje[wybor_indeks()];
+    for (i = 0; i < LICZBA_GRACZY; i++) {
+        czas_gracza[i] = (int32_t)gra->czas_s * SEKUNDA;
+    }
+}
+
+// Czas, ktory ubywa aktywnemu graczowi od poczatku tury do chwili teraz -
+// w trybie US bez pierwszych dodatek_s sekund
+static int32_t zuzyty(czas_t teraz) 
+{
+    int32_t minelo = (int32_t)(teraz - poczatek_tury);
+    
+    if (gra->tryb == TRYB_US) {
+        int32_t opoznienie = (int32_t)gra->dodatek_s * SEKUNDA;
+        minelo = minelo > opoznienie ? minelo - opoznienie : 0;
+    }
+    return minelo;
+}
+
+// Czas gracza w chwili teraz - liczony z podstawy czasu, nie odliczany
+static int32_t czas_w_chwili(uint8_t gracz, czas_t teraz) 
+{
+    int32_t czas = czas_gracza[gracz];
+    
+    if (partia.stan == STAN_GRA && gracz == aktywny) {
+        czas -= zuzyty(teraz);
+    }
+    return czas;
+}
+
+// Co ile zmienia sie wynik na ekranie
+static int32_t krok_ekranu(int32_t czas) 
+{
+    return czas > PROG_DZIESIATYCH ? SEKUNDA : DZIESIATA;
+}
+
+// Zegar na najblizsza zmiane wyniku aktywnego gracza (pelna sekunda, a
+// ponizej 10 s - dziesiata). Liczone z czasu gracza, wiec bez dryfu
+static void zaplanuj_odswiezenie(czas_t teraz) 
+{
+    int32_t czas = czas_w_chwili(aktywny, teraz);
+    int32_t krok = krok_ekranu(czas);
+    int32_t reszta = czas % krok;
+    czas_t od = teraz;
+    
+    // W opoznieniu US czas stoi - pierwsza zmiana liczy sie od jego konca
+    if (gra->tryb == TRYB_US && zuzyty(teraz) == 0) {
+        od = poczatek_tury + (czas_t)gra->dodatek_s * SEKUNDA;
+    }
+    zegar_start_w(&zegar_sekundy, od + (reszta > 0 ? reszta : krok), 0);
 }
 
-// Sprawdzanie czasu
+// Tura gracza od chwili nacisniecia. Ekran zmienia sie tylko wtedy, gdy
+// zmienia sie wynik
+static void zacznij_ture(uint8_t gracz, czas_t chwila) 
+{
+    aktywny = gracz;
+    poczatek_tury = chwila;
+    zaplanuj_odswiezenie(chwila);
+}
+
+// Po kolei - czas dostaje nastepny z tablicy, inaczej ten, kto nacisnal
+static uint8_t nastepny_gracz(uint8_t gracz) 
+{
+    if (KOLEJNOSC == KOLEJNOSC_PO_KOLEI) {
+        return (gracz + 1 < LICZBA_GRACZY) ? gracz + 1 : 0;
+    }
+    return gracz;
+}
+
+// Koniec ruchu gracza w chwili nacisniecia - zuzyty czas i dodatek trybu
+static void zakoncz_ruch(uint8_t gracz, czas_t chwila) 
+{
+    int32_t minelo = zuzyty(chwila);
+    int32_t dodatek = (int32_t)gra->dodatek_s * SEKUNDA;
+    int32_t *czas = &czas_gracza[gracz];
+    
+    *czas -= minelo;
+    if (*czas <= 0) {
+        return;                 // nacisnal juz po czasie - bez dodatku
+    }
+    if (gra->tryb == TRYB_FISCHER) {
+        *czas += dodatek;
+    } else if (gra->tryb == TRYB_BRONSTEIN) {
+        *czas += minelo < dodatek ? minelo : dodatek;
+    }
+}
+
+// Nacisniecie przycisku gracza w danej chwili - co znaczy, wie automat
+void obsluz_ruch(uint8_t gracz, czas_t chwila) 
+{
+    automat_wyslij(&partia, Z_RUCH, gracz, chwila);
+    odswiez_ekran = 1;
+}
+
+// START GRY - czasy wybranej opcji, pierwsza tura od nacisniecia
+void zacznij_gre(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    ustaw_czasy();
+    wybor_stop();
+    zacznij_ture(nastepny_gracz(z->argument), z->chwila);
+}
+
+void zakoncz_gre(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    zegar_stop(&zegar_sekundy);
+}
+
+// Po kolei ruch konczy tylko przycisk aktywnego gracza, w drugim trybie -
+// przycisk kazdego innego
+uint8_t konczy_ruch(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    return (KOLEJNOSC == KOLEJNOSC_PO_KOLEI) == (z->argument == aktywny);
+}
+
+// Aktywny skonczyl ruch - dokladnie tyle, ile minelo od poczatku tury
+void zmien_ture(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    zakoncz_ruch(aktywny, z->chwila);
+    if (czas_gracza[aktywny] <= 0) {
+        // nacisnal juz po czasie - koniec gry po tym przejsciu
+        automat_wyslij(m, Z_CZAS_MINAL, aktywny, z->chwila);
+    } else {
+        zacznij_ture(nastepny_gracz(z->argument), z->chwila);
+    }
+}
+
+// Koniec gry - gracz z argumentu przegral przez czas
+void pokaz_wynik(automat_t *m, const automat_zdarzenie_t *z) 
+{
+    czas_gracza[z->argument] = 0;
+    przegrany = z->argument;
+    odswiez_ekran = 1;
+}
+
+// Dolna polowa przerwania CN - zapamietuje pierwsze zbocze przyciskow,
+// ktore zaczely sie wciskac, i budzi probkowanie. Chwile nacisniecia RD13
+// zatrzasnal sprzetowo IC6 (bufor czytany przy kazdym zboczu, zeby drgania
+// go nie przepelnily), pozostale przyciski nie maja wejscia IC - liczy sie
+// dla nich wejscie do przerwania
+void obsluz_zbocze(uint16_t port, uint32_t chwila) 
+{
+    czas_t zbocze = zbocze_ic6(chwila);
+    uint16_t nowe = ~port & maska_przyciskow & ~(stan_przyciskow.stan | zbocza);
+    
+    zbocza |= nowe;
+    while (nowe) {
+        uint8_t bit = najnizszy_bit(nowe);
+        zbocze_bitu[bit] = (bit == BIT_IC6) ? zbocze : chwila;
+        nowe &= nowe - 1;
+    }
+    if (!zegar_przyciskow.aktywny) {
+        zegar_start(&zegar_przyciskow, PROBKOWANIE, PROBKOWANIE);
+    }
+}
+
+// Probka przyciskow co PROBKOWANIE. Wcisniecie po debouncingu to ruch
+// z chwila pierwszego zbocza, tablica gracz_bitu - bez sprawdzania gracz
+// po graczu
+void probkuj_przyciski(void) 
+{
+    przyciski_zdarzenia_t z;
+    uint16_t wcisniete;
+    
+    przyciski_probka(&stan_przyciskow, PORTD, &z);
+    wcisniete = z.wcisniete;
+    while (wcisniete) {
+        uint8_t bit = najnizszy_bit(wcisniete);
+        uint16_t maska = 1u << bit;
+        obsluz_ruch(gracz_bitu[bit], (zbocza & maska) ? zbocze_bitu[bit] : czas_teraz());
+        wcisniete &= ~maska;
+    }
+    
+    // Zbocze czeka, dopoki licznik bitu liczy do wcisniecia - znika po
+    // wcisnieciu i po drganiu, ktore wcisnieciem nie bylo
+    zbocza &= ~stan_przyciskow.stan & (stan_przyciskow.c0 | stan_przyciskow.c1);
+    if (przyciski_spokoj(&stan_przyciskow) && !zbocza) {
+        zegar_stop(&zegar_przyciskow);
+    }
+}
+
+// Sprawdzanie czasu - najpierw ruchy z przerwania, potem zegary
 void sprawdz_czas(void) 
 {
-    if ((stan_gry == STAN_GRACZ1 || stan_gry == STAN_GRACZ2) && 
-        licznik_ms - ostatnia_sekunda >= 1000) {
-        
-        ostatnia_sekunda = licznik_ms;
-        
-        if (stan_gry == STAN_GRACZ1 && czas_gracz1 > 0) {
-            czas_gracz1--;
-            if (czas_gracz1 == 0) {
-                // Gracz 1 przegral przez czas
-                stan_gry = STAN_KONIEC;
-                zwyciezca = 2;
-            }
-        } else if (stan_gry == STAN_GRACZ2 && czas_gracz2 > 0) {
-            czas_gracz2--;
-            if (czas_gracz2 == 0) {
-                // Gracz 2 przegral przez czas
-                stan_gry = STAN_KONIEC;
-                zwyciezca = 1;
-            }
-        }
-        
-        odswiez_ekran = 1;
+    praca_obsluz();
+    zegary_obsluz();
+}
+
+// Zmiana wyniku aktywnego gracza - co sekunde, ponizej 10 s co dziesiata
+void odlicz_sekunde(void) 
+{
+    czas_t teraz = czas_teraz();
+    
+    // Ruch czeka na rozliczenie albo na debouncing - mogl byc jeszcze przed
+    // ta zmiana. Sprawdzenie po nastepnej probce (jesli to byl ruch,
+    // zacznij_ture i tak zaplanuje zmiane od nowa)
+    if (praca_czeka() || zbocza) {
+        zegar_start(&zegar_sekundy, PROBKOWANIE, 0);
+        return;
     }
+    if (czas_w_chwili(aktywny, teraz) <= 0) {
+        // aktywny gracz przegral przez czas
+        automat_wyslij(&partia, Z_CZAS_MINAL, aktywny, teraz);
+    } else {
+        zaplanuj_odswiezenie(teraz);
+    }
+    odswiez_ekran = 1;
 }
 
-// Wyswietlanie na ekranie
+// Wynik gracza: mm:ss w gore do pelnej sekundy, ponizej 10 s z dziesiata
+// (0 na ekranie dopiero, gdy czas sie skonczyl)
+static void wynik_gracza(char *linia, uint8_t gracz, czas_t teraz) 
+{
+    int32_t czas = czas_w_chwili(gracz, teraz);
+    char znacznik = (gracz == aktywny) ? '*' : ' ';
+    uint16_t sek;
+    
+    if (czas < 0) {
+        czas = 0;
+    }
+    if (czas > PROG_DZIESIATYCH) {
+        sek = (uint16_t)((czas + SEKUNDA - 1) / SEKUNDA);
+        sprintf(linia, "%cGracz%d %02u:%02u", znacznik, gracz + 1, sek / 60, sek % 60);
+    } else {
+        uint16_t dziesiate = (uint16_t)((czas + DZIESIATA - 1) / DZIESIATA);
+        sprintf(linia, "%cGracz%d 00:%02u.%u", znacznik, gracz + 1, dziesiate / 10, dziesiate % 10);
+    }
+}
+
+// Wyswietlanie na ekranie (przez bufor LCD, bez czyszczenia ekranu)
 void pokaz_na_ekranie(void) 
 {
     char linia1[17], linia2[17];
-    uint16_t min1, sek1, min2, sek2;
-    
-    LCD_ClearScreen();
+    czas_t teraz = czas_teraz();
+    uint8_t para;
     
-    switch (stan_gry) {
+    switch (partia.stan) {
         case STAN_WYBOR_CZASU:
             sprintf(linia1, "Wybierz czas:");     
-            sprintf(linia2, "-> %s <-", nazwy_czasow[wybrana_opcja]);
+            sprintf(linia2, "-> %s <-", czasy_opcje[wybor_indeks()].nazwa);
             break;
             
-        case STAN_GRACZ1:
-        case STAN_GRACZ2:
-            min1 = czas_gracz1 / 60;
-            sek1 = czas_gracz1 % 60;
-            min2 = czas_gracz2 / 60;
-            sek2 = czas_gracz2 % 60;
-            
-            // Wyswietl gracza 1 z oznaczeniem aktywnosci
-            if (stan_gry == STAN_GRACZ1) {
-                sprintf(linia1, "*Gracz1 %02d:%02d", min1, sek1);
-            } else {
-                sprintf(linia1, " Gracz1 %02d:%02d", min1, sek1); 
-            }
-            
-            // Wyswietl gracza 2 z oznaczeniem aktywnosci  
-            if (stan_gry == STAN_GRACZ2) {
-                sprintf(linia2, "*Gracz2 %02d:%02d", min2, sek2); 
-            } else {
-                sprintf(linia2, " Gracz2 %02d:%02d", min2, sek2); 
-            }
+        case STAN_GRA:
+            // Para graczy z aktywnym (1-2, 3-4, ...), przy nieparzystej
+            // liczbie graczy ostatni z pierwszym. Gwiazdka przy aktywnym
+            para = aktywny & ~1;
+            wynik_gracza(linia1, para, teraz);
+            wynik_gracza(linia2, (para + 1 < LICZBA_GRACZY) ? para + 1 : 0, teraz);
             break;
             
         case STAN_KONIEC:
             sprintf(linia1, "KONIEC GRY!");    
-            sprintf(linia2, "Wygral gracz %d", zwyciezca);
+            if (LICZBA_GRACZY == 2) {
+                sprintf(linia2, "Wygral gracz %d", (przegrany == 0) ? 2 : 1);
+            } else {
+                sprintf(linia2, "Czas minal: %u", (uint8_t)(przegrany + 1));
+            }
             break;
     }
     
-    LCD_PutString(linia1, strlen(linia1));
-    LCD_PutChar('\n');
-    LCD_PutString(linia2, strlen(linia2));
+    // Do LCD trafiaja tylko znaki, ktore sie zmienily
+    LCD_WriteRow(0, linia1);
+    LCD_WriteRow(1, linia2);
+    LCD_Flush();
 }
 
-// Reset gry
-void resetuj_gre(void) 
+// Reset gry - RESTART PO KONCU GRY i stan poczatkowy
+void resetuj_gre(automat_t *m, const automat_zdarzenie_t *z) 
 {
-    stan_gry = STAN_WYBOR_CZASU;
-    aktywny_gracz = 1;
-    zwyciezca = 0;
-    czas_gracz1 = czasy_opcje[wybrana_opcja];
-    czas_gracz2 = czasy_opcje[wybrana_opcja];
+    aktywny = 0;
+    przegrany = 0;
+    ustaw_czasy();
+    wybor_start();
     odswiez_ekran = 1;
 }
@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=main.c lcd.c
+SOURCEFILES_QUOTED_IF_SPACED=main.c lcd.c ../common/czas.c ../common/zegary.c ../common/wybor.c ../common/praca.c ../common/przyciski.c ../common/automat.c ../common/kolejka.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d ${OBJECTDIR}/lcd.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o ${OBJECTDIR}/_ext/1270477542/czas.o ${OBJECTDIR}/_ext/1270477542/zegary.o ${OBJECTDIR}/_ext/1270477542/wybor.o ${OBJECTDIR}/_ext/1270477542/praca.o ${OBJECTDIR}/_ext/1270477542/przyciski.o ${OBJECTDIR}/_ext/1270477542/automat.o ${OBJECTDIR}/_ext/1270477542/kolejka.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d ${OBJECTDIR}/lcd.o.d ${OBJECTDIR}/_ext/1270477542/czas.o.d ${OBJECTDIR}/_ext/1270477542/zegary.o.d ${OBJECTDIR}/_ext/1270477542/wybor.o.d ${OBJECTDIR}/_ext/1270477542/praca.o.d ${OBJECTDIR}/_ext/1270477542/przyciski.o.d ${OBJECTDIR}/_ext/1270477542/automat.o.d ${OBJECTDIR}/_ext/1270477542/kolejka.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o
+OBJECTFILES=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o ${OBJECTDIR}/_ext/1270477542/czas.o ${OBJECTDIR}/_ext/1270477542/zegary.o ${OBJECTDIR}/_ext/1270477542/wybor.o ${OBJECTDIR}/_ext/1270477542/praca.o ${OBJECTDIR}/_ext/1270477542/przyciski.o ${OBJECTDIR}/_ext/1270477542/automat.o ${OBJECTDIR}/_ext/1270477542/kolejka.o
 
 # Source Files
-SOURCEFILES=main.c lcd.c
+SOURCEFILES=main.c lcd.c ../common/czas.c ../common/zegary.c ../common/wybor.c ../common/praca.c ../common/przyciski.c ../common/automat.c ../common/kolejka.c
 
 
 
@@ -89,30 +89,114 @@ MP_LINKER_FILE_OPTION=,--script=p24FJ128GA010.gld
 # ------------------------------------------------------------------------------------
 # Rules for buildStep: compile
 ifeq ($(TYPE_IMAGE), DEBUG_RUN)
-${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/2eb0a9f3562b44dee1108d48ecfd5eac7d4216d9 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/271162bac6f9f534fe5bd2311152f51543c346c6 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/main.o.d 
 	@${RM} ${OBJECTDIR}/main.o 
-	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
-${OBJECTDIR}/lcd.o: lcd.c  .generated_files/flags/default/10a47d855f8397d2195a0ccc1a9944f5d93a4e20 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+${OBJECTDIR}/lcd.o: lcd.c  .generated_files/flags/default/c1b541b99352b6ef0ace6dd4c7c1cb5dd2ef8a74 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/lcd.o.d 
 	@${RM} ${OBJECTDIR}/lcd.o 
-	${MP_CC} $(MP_EXTRA_CC_PRE)  lcd.c  -o ${OBJECTDIR}/lcd.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/lcd.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	${MP_CC} $(MP_EXTRA_CC_PRE)  lcd.c  -o ${OBJECTDIR}/lcd.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/lcd.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/czas.o: ../common/czas.c  .generated_files/flags/default/98b4aa976abd19750651d56170a81911759ef5ed .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/czas.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/czas.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/czas.c  -o ${OBJECTDIR}/_ext/1270477542/czas.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/czas.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/zegary.o: ../common/zegary.c  .generated_files/flags/default/3dcb65a7094a0aac32665ec5da7ccfb91ef1c64b .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/zegary.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/zegary.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/zegary.c  -o ${OBJECTDIR}/_ext/1270477542/zegary.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/zegary.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/wybor.o: ../common/wybor.c  .generated_files/flags/default/e0fdd852a20f1659556da91721d9539c77e2bcb3 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/wybor.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/wybor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/wybor.c  -o ${OBJECTDIR}/_ext/1270477542/wybor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/wybor.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/praca.o: ../common/praca.c  .generated_files/flags/default/fd19c4b231ed97cb844a0e3bd7634345f4448318 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/praca.c  -o ${OBJECTDIR}/_ext/1270477542/praca.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/praca.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/przyciski.o: ../common/przyciski.c  .generated_files/flags/default/9c8f9566d0b524a9180d476051ffdaaa90d0b12b .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/przyciski.c  -o ${OBJECTDIR}/_ext/1270477542/przyciski.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/przyciski.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/automat.o: ../common/automat.c  .generated_files/flags/default/50897f9d2a148e72671e59bbbe466378297cd255 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/automat.c  -o ${OBJECTDIR}/_ext/1270477542/automat.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/automat.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/kolejka.o: ../common/kolejka.c  .generated_files/flags/default/22bdbc078af360ec2c27945839665ba3fa9f8e21 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/kolejka.c  -o ${OBJECTDIR}/_ext/1270477542/kolejka.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/kolejka.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1    -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
 else
-${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/e528a07b514d9424625c9042639e331e08ffe35c .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/1d8b8229cb0ed15b8637a8000324ff79f561e169 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/main.o.d 
 	@${RM} ${OBJECTDIR}/main.o 
-	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	${MP_CC} $(MP_EXTRA_CC_PRE)  main.c  -o ${OBJECTDIR}/main.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/main.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
-${OBJECTDIR}/lcd.o: lcd.c  .generated_files/flags/default/d3b4d17fab509af0566cb3f907f6ea7738400930 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+${OBJECTDIR}/lcd.o: lcd.c  .generated_files/flags/default/e1fc2090b3a524efa4c93a797cc7bce46a007aa0 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/lcd.o.d 
 	@${RM} ${OBJECTDIR}/lcd.o 
-	${MP_CC} $(MP_EXTRA_CC_PRE)  lcd.c  -o ${OBJECTDIR}/lcd.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/lcd.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	${MP_CC} $(MP_EXTRA_CC_PRE)  lcd.c  -o ${OBJECTDIR}/lcd.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/lcd.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/czas.o: ../common/czas.c  .generated_files/flags/default/301e6137e40d5b3d373c60cb8343e9466644880f .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/czas.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/czas.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/czas.c  -o ${OBJECTDIR}/_ext/1270477542/czas.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/czas.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/zegary.o: ../common/zegary.c  .generated_files/flags/default/2a034d198166cf0698a6ecc3baa39c024e1e8b6e .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/zegary.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/zegary.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/zegary.c  -o ${OBJECTDIR}/_ext/1270477542/zegary.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/zegary.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/wybor.o: ../common/wybor.c  .generated_files/flags/default/8ae2f08e1f472bae4ab7cf03c32bc4a60bc6d7e5 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/wybor.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/wybor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/wybor.c  -o ${OBJECTDIR}/_ext/1270477542/wybor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/wybor.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/praca.o: ../common/praca.c  .generated_files/flags/default/b1798941f296e5198ec1ec1d23f8362fa903ea4a .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/praca.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/praca.c  -o ${OBJECTDIR}/_ext/1270477542/praca.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/praca.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/przyciski.o: ../common/przyciski.c  .generated_files/flags/default/adf0b773c82ddd93b3aaadafbb636bbefec26b46 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/przyciski.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/przyciski.c  -o ${OBJECTDIR}/_ext/1270477542/przyciski.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/przyciski.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/automat.o: ../common/automat.c  .generated_files/flags/default/9ec00e9ed80ef6ef1fbf42f814f7c2e9ccf24a23 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/automat.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/automat.c  -o ${OBJECTDIR}/_ext/1270477542/automat.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/automat.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/_ext/1270477542/kolejka.o: ../common/kolejka.c  .generated_files/flags/default/41cc4bb64b191b616ef3f0161df4785becf559f6 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/_ext/1270477542" 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1270477542/kolejka.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../common/kolejka.c  -o ${OBJECTDIR}/_ext/1270477542/kolejka.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/_ext/1270477542/kolejka.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"../common" -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
 endif
 
@@ -0,0 +1,211 @@
+/*
+ * File:   automat.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Automat stanow z tablic i kolejka zdarzen z przerwan - opis w automat.h.
+ */
+
+#include "automat.h"
+#include "kolejka.h"
+
+static automat_zdarzenie_t wpisy[AUTOMAT_KOLEJKA];
+static kolejka_t kolejka = KOLEJKA(wpisy);
+
+volatile uint16_t automat_zgubione = 0;
+
+// Przejscia w toku (akcja jednego automatu moze wyslac zdarzenie do
+// innego) - kolejke obsluguje dopiero najbardziej zewnetrzne
+static uint8_t w_toku = 0;
+
+#if AUTOMAT_SLAD
+automat_slad_t automat_slad[AUTOMAT_SLAD];
+uint16_t automat_przejscia = 0;
+#endif
+
+static uint8_t rodzic(const automat_t *a, uint8_t stan)
+{
+    return a->opis->stany[stan].rodzic;
+}
+
+static uint8_t glebokosc(const automat_t *a, uint8_t stan)
+{
+    uint8_t g = 0;
+
+    while ((stan = rodzic(a, stan)) != AUTOMAT_BRAK) {
+        g++;
+    }
+    return g;
+}
+
+// Wejscie od stanu tuz pod przodkiem w dol do celu - droga zbierana
+// od celu w gore, wiec wywolania od konca
+static void wejdz(automat_t *a, uint8_t przodek, uint8_t cel, const automat_zdarzenie_t *z)
+{
+    uint8_t droga[AUTOMAT_GLEBOKOSC];
+    uint8_t n = 0;
+
+    while (cel != przodek && n < AUTOMAT_GLEBOKOSC) {
+        droga[n++] = cel;
+        cel = rodzic(a, cel);
+    }
+    while (n > 0) {
+        automat_akcja_t wejscie = a->opis->stany[droga[--n]].wejscie;
+        if (wejscie != NULL) {
+            wejscie(a, z);
+        }
+    }
+}
+
+// Zmiana stanu: wyjscie do wspolnego przodka, akcja, wejscie do celu.
+// Przejscie do tego samego stanu wychodzi z niego i wchodzi od nowa
+static void zmien_stan(automat_t *a, const automat_przejscie_t *p, const automat_zdarzenie_t *z)
+{
+    uint8_t poprzedni = a->stan;
+    uint8_t stan = poprzedni;
+    uint8_t x = stan;
+    uint8_t y = p->cel;
+    uint8_t gx = glebokosc(a, x);
+    uint8_t gy = glebokosc(a, y);
+
+    // Wspolny przodek - najpierw na rowna glebokosc, potem razem w gore
+    while (gx > gy) {
+        x = rodzic(a, x);
+        gx--;
+    }
+    while (gy > gx) {
+        y = rodzic(a, y);
+        gy--;
+    }
+    while (x != y) {
+        x = rodzic(a, x);
+        y = rodzic(a, y);
+    }
+    if (stan == p->cel) {
+        x = rodzic(a, stan);
+    }
+
+    while (stan != x) {
+        automat_akcja_t wyjscie = a->opis->stany[stan].wyjscie;
+        if (wyjscie != NULL) {
+            wyjscie(a, z);
+        }
+        stan = rodzic(a, stan);
+    }
+    if (p->akcja != NULL) {
+        p->akcja(a, z);
+    }
+    a->stan = p->cel;
+    wejdz(a, x, p->cel, z);
+
+#if AUTOMAT_SLAD
+    {
+        automat_slad_t *s = &automat_slad[automat_przejscia & (AUTOMAT_SLAD - 1)];
+        s->automat = a->numer;
+        s->z = poprzedni;
+        s->na = p->cel;
+        s->zdarzenie = z->numer;
+        automat_przejscia++;
+    }
+#endif
+}
+
+// Przejscie dla zdarzenia - stan biezacy, potem rodzice. 1, gdy bylo
+static uint8_t rozpatrz(automat_t *a, const automat_zdarzenie_t *z)
+{
+    const automat_opis_t *o = a->opis;
+    uint8_t stan = a->stan;
+
+    if (z->numer >= o->liczba_zdarzen) {
+        return 0;
+    }
+    while (stan != AUTOMAT_BRAK) {
+        const automat_przejscie_t *p = &o->przejscia[stan * o->liczba_zdarzen + z->numer];
+
+        if (p->rodzaj != AUTOMAT_NIC && (p->warunek == NULL || p->warunek(a, z))) {
+            w_toku++;
+            if (p->rodzaj == AUTOMAT_ZMIANA) {
+                zmien_stan(a, p, z);
+            } else if (p->akcja != NULL) {
+                p->akcja(a, z);
+            }
+            w_toku--;
+            return 1;
+        }
+        stan = o->stany[stan].rodzic;
+    }
+    return 0;
+}
+
+void automat_init(automat_t *a, const automat_opis_t *opis, uint8_t numer)
+{
+    automat_zdarzenie_t z = { a, AUTOMAT_BRAK, 0, 0 };
+
+    a->opis = opis;
+    a->numer = numer;
+    a->stan = opis->poczatkowy;
+    w_toku++;
+    wejdz(a, AUTOMAT_BRAK, opis->poczatkowy, &z);
+    w_toku--;
+}
+
+uint8_t automat_w_stanie(const automat_t *a, uint8_t stan)
+{
+    uint8_t s = a->stan;
+
+    while (s != AUTOMAT_BRAK && s != stan) {
+        s = rodzic(a, s);
+    }
+    return s == stan;
+}
+
+void automat_zglos(automat_t *a, uint8_t numer, uint16_t argument, uint32_t chwila)
+{
+    automat_zdarzenie_t *p = kolejka_miejsce(&kolejka);
+
+    if (p == NULL) {
+        automat_zgubione++;
+        return;
+    }
+    p->automat = a;
+    p->numer = numer;
+    p->argument = argument;
+    p->chwila = chwila;
+    kolejka_wstaw(&kolejka);
+}
+
+uint8_t automat_czeka(void)
+{
+    return kolejka_czeka(&kolejka);
+}
+
+// Kopia zdarzenia zwalnia miejsce przed przejsciem - akcje moga zglaszac
+// nastepne
+void automat_obsluz(void)
+{
+    const automat_zdarzenie_t *w;
+    automat_zdarzenie_t z;
+
+    if (w_toku) {
+        return;                 // reszta po biezacym przejsciu
+    }
+    while ((w = kolejka_pierwszy(&kolejka)) != NULL) {
+        z = *w;
+        kolejka_zdejmij(&kolejka);
+        rozpatrz(z.automat, &z);
+    }
+}
+
+// Od razu z petli glownej, gdy nic nie czeka. Zdarzenie z akcji albo przy
+// zdarzeniach zgloszonych wczesniej - do kolejki za nimi, zeby zachowac
+// kolejnosc (wtedy, jak automat_zglos, przy IPL przerwan, ktore zglaszaja)
+void automat_wyslij(automat_t *a, uint8_t numer, uint16_t argument, uint32_t chwila)
+{
+    automat_zdarzenie_t z = { a, numer, argument, chwila };
+
+    if (w_toku || automat_czeka()) {
+        automat_zglos(a, numer, argument, chwila);
+    } else {
+        rozpatrz(a, &z);
+    }
+    automat_obsluz();
+}
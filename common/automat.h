@@ -0,0 +1,127 @@
+/*
+ * File:   automat.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Automat stanow z tablic - hierarchiczny, z akcjami wejscia i wyjscia.
+ *
+ * Opis automatu to stale tablice (pamiec programu): stany z rodzicem
+ * i akcjami wejscia/wyjscia oraz przejscia [stan][zdarzenie]. Zdarzenie
+ * szuka przejscia jednym indeksem w tablicy - najpierw w stanie biezacym,
+ * potem w jego rodzicach, wiec wspolne przejscia wystarczy wpisac raz
+ * w stanie nadrzednym. Przejscie moze miec warunek (gdy niespelniony,
+ * szukanie idzie do rodzica) i akcje. Przy zmianie stanu wywolywane sa
+ * akcje wyjscia od stanu biezacego w gore do wspolnego przodka, akcja
+ * przejscia i akcje wejscia w dol do stanu docelowego. Przejscie
+ * wewnetrzne wywoluje tylko akcje, bez wyjscia i wejscia. Aktywny
+ * i docelowy jest zawsze stan-lisc, stany nadrzedne tylko grupuja.
+ *
+ *     static const automat_przejscie_t przejscia[STANY][ZDARZENIA] = {
+ *         [STAN_STOP][Z_START] = PRZEJSCIE(STAN_DZIALA, jest_czas, NULL),
+ *         [STAN_DZIALA][Z_SEKUNDA] = WEWNETRZNE(NULL, odlicz),
+ *     };
+ *
+ * Zdarzenia z przerwan ida przez kolejke (automat_zglos), a obsluguje je
+ * petla glowna (automat_obsluz) - jak praca.h, na tej samej kolejce
+ * jednego piszacego i jednego czytajacego (kolejka.h). Petla glowna moze
+ * tez wyslac zdarzenie od razu (automat_wyslij) - wyslane z akcji czeka
+ * w kolejce na koniec biezacego przejscia, a gdy w kolejce sa wczesniejsze
+ * zdarzenia, nowe idzie za nimi.
+ *
+ * AUTOMAT_SLAD - ostatnie przejscia wszystkich automatow (z, do, zdarzenie)
+ * w buforze kolowym do podgladu w debuggerze, 0 - bez sladu.
+ */
+
+#ifndef AUTOMAT_H
+#define AUTOMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define AUTOMAT_KOLEJKA         16      // potega 2
+#define AUTOMAT_GLEBOKOSC       4       // najwyzej tyle poziomow stanow
+#ifndef AUTOMAT_SLAD
+#define AUTOMAT_SLAD            16      // potega 2, 0 - bez sladu
+#endif
+
+#define AUTOMAT_BRAK            0xFF    // brak rodzica
+
+typedef struct automat automat_t;
+
+// Zdarzenie - argument i chwila wybiera nadawca (jak w praca.h)
+typedef struct {
+    automat_t *automat;
+    uint8_t numer;
+    uint16_t argument;
+    uint32_t chwila;
+} automat_zdarzenie_t;
+
+typedef void (*automat_akcja_t)(automat_t *a, const automat_zdarzenie_t *z);
+typedef uint8_t (*automat_warunek_t)(automat_t *a, const automat_zdarzenie_t *z);
+
+typedef struct {
+    uint8_t rodzic;             // AUTOMAT_BRAK - stan najwyzszy
+    automat_akcja_t wejscie;    // NULL - bez akcji
+    automat_akcja_t wyjscie;
+} automat_stan_t;
+
+// Rodzaj przejscia - 0, zeby puste miejsca tablicy nie mialy przejscia
+#define AUTOMAT_NIC             0
+#define AUTOMAT_ZMIANA          1
+#define AUTOMAT_WEWNETRZNE      2
+
+typedef struct {
+    uint8_t rodzaj;
+    uint8_t cel;                // stan docelowy (AUTOMAT_ZMIANA)
+    automat_warunek_t warunek;  // NULL - zawsze
+    automat_akcja_t akcja;      // NULL - bez akcji
+} automat_przejscie_t;
+
+#define PRZEJSCIE(cel, warunek, akcja)  { AUTOMAT_ZMIANA, (cel), (warunek), (akcja) }
+#define WEWNETRZNE(warunek, akcja)      { AUTOMAT_WEWNETRZNE, 0, (warunek), (akcja) }
+
+typedef struct {
+    const automat_stan_t *stany;
+    const automat_przejscie_t *przejscia;   // [liczba_stanow][liczba_zdarzen]
+    uint8_t liczba_stanow;
+    uint8_t liczba_zdarzen;
+    uint8_t poczatkowy;                     // stan-lisc
+} automat_opis_t;
+
+struct automat {
+    const automat_opis_t *opis;
+    uint8_t stan;
+    uint8_t numer;              // np. kanal - dla akcji wspolnych automatow
+};
+
+#if (AUTOMAT_KOLEJKA & (AUTOMAT_KOLEJKA - 1)) || (AUTOMAT_KOLEJKA > 128)
+#error "AUTOMAT_KOLEJKA musi byc potega 2, najwyzej 128"
+#endif
+
+#if AUTOMAT_SLAD & (AUTOMAT_SLAD - 1)
+#error "AUTOMAT_SLAD musi byc potega 2 albo 0"
+#endif
+
+extern volatile uint16_t automat_zgubione;  // zdarzenia przy pelnej kolejce
+
+#if AUTOMAT_SLAD
+typedef struct {
+    uint8_t automat;            // numer automatu
+    uint8_t z;
+    uint8_t na;
+    uint8_t zdarzenie;
+} automat_slad_t;
+
+extern automat_slad_t automat_slad[AUTOMAT_SLAD];
+extern uint16_t automat_przejscia;  // wszystkie, ostatnie w [(n - 1) & maska]
+#endif
+
+// Stan poczatkowy z akcjami wejscia (zdarzenie o numerze AUTOMAT_BRAK)
+void automat_init(automat_t *a, const automat_opis_t *opis, uint8_t numer);
+uint8_t automat_w_stanie(const automat_t *a, uint8_t stan);   // takze nadrzednym
+
+void automat_zglos(automat_t *a, uint8_t numer, uint16_t argument, uint32_t chwila);
+void automat_wyslij(automat_t *a, uint8_t numer, uint16_t argument, uint32_t chwila);
+uint8_t automat_czeka(void);            // czy kolejka ma zdarzenia
+void automat_obsluz(void);              // cala kolejka - w petli glownej
+
+#endif // AUTOMAT_H
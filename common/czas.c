@@ -0,0 +1,92 @@
+/*
+ * File:   czas.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Podstawa czasu na Timer2/3 (32-bit) i budzik na Timer1 - opis w czas.h.
+ */
+
+#include <xc.h>
+#include "czas.h"
+#include "pomiar.h"
+
+// Czas wykonania przerwania budzika (pomiar.h) - do podgladu w debuggerze
+pomiar_t pomiar_budzika;
+
+void czas_init(void)
+{
+    // Timer2/3 jako jeden licznik 32-bit, bez przerwan
+    T2CON = 0;
+    T3CON = 0;
+    TMR3 = 0;
+    TMR2 = 0;
+    PR3 = 0xFFFF;               // pelny zakres 32-bit
+    PR2 = 0xFFFF;
+    IEC0bits.T3IE = 0;
+    T2CONbits.T32 = 1;
+    T2CONbits.TCKPS = CZAS_TCKPS;
+    T2CONbits.TON = 1;
+
+    // Timer1 - budzik, uruchamiany przez czas_budzik()
+    T1CON = 0;
+    TMR1 = 0;
+    T1CONbits.TCKPS = CZAS_BUDZIK_TCKPS;
+    IPC0bits.T1IP = CZAS_BUDZIK_PRIORYTET;
+    IFS0bits.T1IF = 0;
+    IEC0bits.T1IE = 1;
+}
+
+// Starsza polowa przed i po mlodszej - rozne tylko wtedy, gdy mlodsza
+// przekrecila sie w trakcie, i wtedy odczyt jeszcze raz. Bez TMR3HLD, ktory
+// przerwanie mogloby nadpisac, i bez IPL 7 - wolno wolac z przerwan i nie
+// opoznia przerwan
+czas_t czas_teraz(void)
+{
+    uint16_t mlodsza, starsza;
+
+    do {
+        starsza = TMR3;
+        mlodsza = TMR2;
+    } while (starsza != TMR3);
+
+    return ((czas_t)starsza << 16) | mlodsza;
+}
+
+// Przerwanie od Timer1 najpozniej w terminie. Termin odlegly o wiecej niz
+// zakres Timer1 budzi wczesniej - petla glowna ustawi wtedy budzik ponownie
+void czas_budzik(czas_t termin)
+{
+    int32_t zostalo = (int32_t)(termin - czas_teraz());
+    uint32_t impulsy;
+
+    T1CONbits.TON = 0;
+    if (zostalo <= 0) {
+        IFS0bits.T1IF = 1;      // termin minal - od razu
+        return;
+    }
+
+    // Zaokraglenie w gore - budzik nie moze zadzwonic przed terminem
+    impulsy = ((uint32_t)zostalo + CZAS_BUDZIK_DZIELNIK - 1) / CZAS_BUDZIK_DZIELNIK;
+    if (impulsy > 0x10000UL) {
+        impulsy = 0x10000UL;
+    }
+    TMR1 = 0;
+    PR1 = (uint16_t)(impulsy - 1);
+    IFS0bits.T1IF = 0;
+    T1CONbits.TON = 1;
+}
+
+void czas_budzik_wylacz(void)
+{
+    T1CONbits.TON = 0;
+    IFS0bits.T1IF = 0;
+}
+
+// Budzik jest jednorazowy - samo przerwanie wybudza petle glowna z Idle()
+void __attribute__((interrupt, no_auto_psv)) _T1Interrupt(void)
+{
+    POMIAR_START();
+
+    T1CONbits.TON = 0;
+    IFS0bits.T1IF = 0;
+    POMIAR_KONIEC(pomiar_budzika);
+}
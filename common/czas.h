@@ -0,0 +1,54 @@
+/*
+ * File:   czas.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Podstawa czasu bez przerwania co 1 ms (tickless).
+ *
+ * Timer2/3 w trybie 32-bit liczy bez przerwy impulsy 2 us (preskaler 1:8)
+ * i nigdy nie jest zatrzymywany ani zerowany - czas_teraz() to jego odczyt,
+ * wiec dluga praca w petli glownej albo w przerwaniu nie gubi czasu.
+ * Licznik przekreca sie co ok. 2,4 h, dlatego terminy porownuje sie tylko
+ * przez CZAS_MINAL (roznica ze znakiem).
+ *
+ * Timer1 sluzy wylacznie jako budzik: czas_budzik(termin) ustawia jedno
+ * przerwanie na chwile terminu (lub wczesniej, gdy termin jest dalej niz
+ * ok. 1 s) - po nim petla glowna sama sprawdza, co juz minelo.
+ * Zajete: Timer1, Timer2, Timer3.
+ */
+
+#ifndef CZAS_H
+#define CZAS_H
+
+#include <stdint.h>
+#include "taktowanie.h"
+
+typedef uint32_t czas_t;                // impulsy CZAS_IMPULS_US
+
+// Timer2/3: preskaler 1:8 (TCKPS = 0b01)
+#define CZAS_PRESKALER          8
+#define CZAS_TCKPS              0b01
+#define CZAS_IMPULS_US          (CZAS_PRESKALER / (FCY / 1000000UL))
+
+#define CZAS_US(us)             ((czas_t)((FCY / 1000000UL) * (us) / CZAS_PRESKALER))
+#define CZAS_MS(ms)             CZAS_US((ms) * 1000UL)
+
+// Czy termin juz minal (dziala przez przepelnienie licznika)
+#define CZAS_MINAL(teraz, termin)   ((int32_t)((teraz) - (termin)) >= 0)
+
+// Budzik na Timer1: preskaler 1:64 - impuls to 8 impulsow podstawy czasu,
+// najdluzsze jednorazowe odliczanie 65536 * 16 us = ok. 1 s
+#define CZAS_BUDZIK_PRESKALER   64
+#define CZAS_BUDZIK_TCKPS       0b10
+#define CZAS_BUDZIK_DZIELNIK    (CZAS_BUDZIK_PRESKALER / CZAS_PRESKALER)
+#define CZAS_BUDZIK_PRIORYTET   3
+
+#if CZAS_IMPULS_US < 1
+#error "Podstawa czasu szybsza niz 1 us - zmien CZAS_PRESKALER"
+#endif
+
+void czas_init(void);
+czas_t czas_teraz(void);
+void czas_budzik(czas_t termin);        // przerwanie (wybudzenie z Idle) w terminie
+void czas_budzik_wylacz(void);
+
+#endif // CZAS_H
@@ -0,0 +1,27 @@
+/*
+ * File:   hal.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Dostep do sprzetu tam, gdzie zwykly rejestr nie wystarcza. Zapis i
+ * odczyt PMDIN1 uruchamiaja cykl na szynie PMP, a model rejestrow na PC
+ * (host/, SYMULACJA) nie odroznilby ich od zwyklego dostepu. Na PIC24
+ * makra to po prostu dostep do rejestru.
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+
+#ifdef SYMULACJA
+void sim_pmp_zapis(uint16_t dana);
+uint16_t sim_pmp_odczyt(void);
+
+#define HAL_PMP_ZAPIS(dana)     sim_pmp_zapis(dana)
+#define HAL_PMP_ODCZYT()        sim_pmp_odczyt()
+#else
+#define HAL_PMP_ZAPIS(dana)     (PMDIN1 = (dana))
+#define HAL_PMP_ODCZYT()        (PMDIN1)
+#endif
+
+#endif // HAL_H
@@ -0,0 +1,52 @@
+/*
+ * File:   kolejka.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Kolejka jednego piszacego i jednego czytajacego - opis w kolejka.h.
+ */
+
+#include "kolejka.h"
+#include "sekwencja.h"          // SEKWENCJA_BARIERA
+
+static void *wpis(const kolejka_t *k, uint8_t indeks)
+{
+    return (uint8_t *)k->wpisy + (uint16_t)(indeks & k->maska) * k->rozmiar;
+}
+
+void *kolejka_miejsce(kolejka_t *k)
+{
+    uint8_t z = k->zapis;
+
+    if ((uint8_t)(z - k->odczyt) > k->maska) {
+        return NULL;
+    }
+    return wpis(k, z);
+}
+
+void kolejka_wstaw(kolejka_t *k)
+{
+    SEKWENCJA_BARIERA();        // wpis caly, zanim czytajacy go zobaczy
+    k->zapis++;
+}
+
+const void *kolejka_pierwszy(kolejka_t *k)
+{
+    uint8_t o = k->odczyt;
+
+    if (o == k->zapis) {
+        return NULL;
+    }
+    SEKWENCJA_BARIERA();        // wpis czytany dopiero po indeksie
+    return wpis(k, o);
+}
+
+void kolejka_zdejmij(kolejka_t *k)
+{
+    SEKWENCJA_BARIERA();        // kopia wpisu przed zwolnieniem miejsca
+    k->odczyt++;
+}
+
+uint8_t kolejka_czeka(const kolejka_t *k)
+{
+    return k->zapis != k->odczyt;
+}
@@ -0,0 +1,53 @@
+/*
+ * File:   kolejka.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Kolejka wpisow z przerwania do petli glownej - jeden piszacy (jedno
+ * przerwanie albo kilka o tym samym priorytecie, albo petla glowna przy
+ * IPL tego priorytetu) i jeden czytajacy, bez blokad.
+ *
+ * Wpisy to tablica uzytkownika dowolnego typu, kolejka ma tylko indeksy.
+ * Piszacy wypelnia wolne miejsce i dopiero wtedy je wstawia, czytajacy
+ * kopiuje najstarszy wpis i zdejmuje go, zanim go obsluzy:
+ *
+ *     static praca_t wpisy[8];
+ *     static kolejka_t kolejka = KOLEJKA(wpisy);
+ *
+ *     p = kolejka_miejsce(&kolejka);      // NULL - pelna
+ *     ...wypelnij *p...
+ *     kolejka_wstaw(&kolejka);
+ *
+ *     while ((p = kolejka_pierwszy(&kolejka)) != NULL) {
+ *         kopia = *p;
+ *         kolejka_zdejmij(&kolejka);
+ *         ...obsluz kopie...
+ *     }
+ */
+
+#ifndef KOLEJKA_H
+#define KOLEJKA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Indeksy licza bez konca (8-bit, zapis jednym rozkazem), pozycja to
+// indeks & maska, a zajete miejsca to ich roznica. zapis zmienia tylko
+// piszacy, odczyt - tylko czytajacy
+typedef struct {
+    void *wpisy;
+    uint8_t rozmiar;            // bajty wpisu
+    uint8_t maska;              // liczba wpisow - 1 (potega 2, najwyzej 128)
+    volatile uint8_t zapis;
+    volatile uint8_t odczyt;
+} kolejka_t;
+
+#define KOLEJKA(tablica) \
+    { (tablica), sizeof((tablica)[0]), sizeof(tablica) / sizeof((tablica)[0]) - 1, 0, 0 }
+
+void *kolejka_miejsce(kolejka_t *k);            // piszacy - NULL, gdy pelna
+void kolejka_wstaw(kolejka_t *k);               // wpis w miejscu jest caly
+const void *kolejka_pierwszy(kolejka_t *k);     // czytajacy - NULL, gdy pusta
+void kolejka_zdejmij(kolejka_t *k);             // miejsce wolne dla piszacego
+uint8_t kolejka_czeka(const kolejka_t *k);      // czy sa wpisy
+
+#endif // KOLEJKA_H
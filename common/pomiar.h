@@ -0,0 +1,60 @@
+/*
+ * File:   pomiar.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Czas wykonania przerwan w cyklach Tcy - ostatni i najdluzszy (WCET).
+ *
+ * Timer5 liczy swobodnie Tcy (preskaler 1:1, PR5 = 0xFFFF). Przerwanie
+ * zapamietuje TMR5 na poczatku i dopisuje roznice do swojego licznika
+ * na koncu:
+ *
+ *     pomiar_t pomiar_cn;
+ *
+ *     void __attribute__((interrupt, no_auto_psv)) _CNInterrupt(void) {
+ *         POMIAR_START();
+ *         ...
+ *         POMIAR_KONIEC(pomiar_cn);
+ *     }
+ *
+ * Liczniki sa zwyklymi zmiennymi globalnymi - na PIC24 do podgladu
+ * w oknie Watch debuggera. Pomiar nie obejmuje wejscia do przerwania
+ * i zapisu rejestrow (kilkanascie Tcy), wlicza za to przerwania o wyzszym
+ * priorytecie, ktore trafily w srodek. Dluzej niz 16 ms (65536 Tcy) sie
+ * przekreca. W Sleep() Timer5 stoi.
+ * Zajety: Timer5.
+ */
+
+#ifndef POMIAR_H
+#define POMIAR_H
+
+#include <stdint.h>
+#include <xc.h>
+
+typedef struct {
+    uint16_t ostatni;           // Tcy ostatniego wywolania
+    uint16_t max;               // najdluzsze wywolanie
+    uint16_t wywolania;
+} pomiar_t;
+
+#define POMIAR_START()          uint16_t pomiar_poczatek = TMR5
+#define POMIAR_KONIEC(p)        pomiar_dopisz(&(p), TMR5 - pomiar_poczatek)
+
+// Timer5 - swobodny licznik Tcy, przed wlaczeniem przerwan
+static inline void pomiar_init(void)
+{
+    T5CON = 0;
+    TMR5 = 0;
+    PR5 = 0xFFFF;
+    T5CONbits.TON = 1;
+}
+
+static inline void pomiar_dopisz(pomiar_t *p, uint16_t cykle)
+{
+    p->ostatni = cykle;
+    if (cykle > p->max) {
+        p->max = cykle;
+    }
+    p->wywolania++;
+}
+
+#endif // POMIAR_H
@@ -0,0 +1,50 @@
+/*
+ * File:   praca.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Kolejka pracy odroczonej z przerwan do petli glownej - opis w praca.h.
+ */
+
+#include <stddef.h>
+#include "praca.h"
+#include "kolejka.h"
+
+static praca_t wpisy[PRACA_KOLEJKA];
+static kolejka_t kolejka = KOLEJKA(wpisy);
+
+volatile uint16_t praca_zgubione = 0;
+
+void praca_zglos(praca_obsluga_t obsluga, uint16_t port, uint32_t chwila)
+{
+    praca_t *p = kolejka_miejsce(&kolejka);
+
+    if (p == NULL) {
+        praca_zgubione++;
+        return;
+    }
+    p->obsluga = obsluga;
+    p->port = port;
+    p->chwila = chwila;
+    kolejka_wstaw(&kolejka);
+}
+
+uint8_t praca_czeka(void)
+{
+    return kolejka_czeka(&kolejka);
+}
+
+// Kopia wpisu zwalnia miejsce jeszcze przed obsluga - obsluga moze trwac
+// dowolnie dlugo, a przerwanie ma wtedy cala kolejke
+void praca_obsluz(void)
+{
+    const praca_t *w;
+    praca_t p;
+
+    while ((w = kolejka_pierwszy(&kolejka)) != NULL) {
+        p = *w;
+        kolejka_zdejmij(&kolejka);
+        if (p.obsluga != NULL) {
+            p.obsluga(p.port, p.chwila);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * File:   praca.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Praca odroczona - przerwanie dzielone na gorna i dolna polowe.
+ *
+ * Gorna polowa (przerwanie) tylko zapisuje migawke portu i chwile
+ * zdarzenia i wstawia je do kolejki razem z funkcja obslugi:
+ *
+ *     praca_zglos(obsluz_przycisk, PORTD, czas_teraz());
+ *
+ * Dolna polowa to obsluga wywolana w petli glownej przez praca_obsluz() -
+ * moze zmieniac stan programu, pisac na LCD i uruchamiac zegary, a
+ * przerwania w tym czasie dzialaja. Kolejka ma jednego piszacego (jedno
+ * przerwanie albo kilka o tym samym priorytecie) i jednego czytajacego
+ * (petla glowna), wiec wystarczy indeks zapisu i indeks odczytu, bez
+ * blokad. Gdy kolejka jest pelna, zgloszenie przepada i liczy sie
+ * w praca_zgubione.
+ */
+
+#ifndef PRACA_H
+#define PRACA_H
+
+#include <stdint.h>
+
+#define PRACA_KOLEJKA           8       // potega 2
+
+// Obsluga dostaje migawke portu i chwile z przerwania - jednostke chwili
+// wybiera przerwanie (czas_t z czas.h albo cykle Timer5 z pomiar.h)
+typedef void (*praca_obsluga_t)(uint16_t port, uint32_t chwila);
+
+typedef struct {
+    praca_obsluga_t obsluga;
+    uint16_t port;
+    uint32_t chwila;
+} praca_t;
+
+#if (PRACA_KOLEJKA & (PRACA_KOLEJKA - 1)) || (PRACA_KOLEJKA > 128)
+#error "PRACA_KOLEJKA musi byc potega 2, najwyzej 128"
+#endif
+
+extern volatile uint16_t praca_zgubione;    // zgloszenia przy pelnej kolejce
+
+void praca_zglos(praca_obsluga_t obsluga, uint16_t port, uint32_t chwila);  // z przerwania
+uint8_t praca_czeka(void);              // czy jest cos do obsluzenia
+void praca_obsluz(void);                // wszystkie zgloszenia - w petli glownej
+
+#endif // PRACA_H
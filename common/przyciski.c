@@ -0,0 +1,65 @@
+/*
+ * File:   przyciski.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Debouncing na licznikach pionowych - opis w przyciski.h.
+ */
+
+#include "przyciski.h"
+
+#define DLUGO           PRZYCISKI_PROBEK(PRZYCISKI_DLUGO_MS)
+#define POWTORZ         PRZYCISKI_PROBEK(PRZYCISKI_POWTORZ_MS)
+#define POWTORZ_MIN     PRZYCISKI_PROBEK(PRZYCISKI_POWTORZ_MIN_MS)
+
+void przyciski_init(przyciski_t *p, uint16_t maska)
+{
+    p->maska = maska;
+    p->stan = 0;
+    p->c0 = 0;
+    p->c1 = 0;
+    p->trzymane = 0;
+    p->okres = POWTORZ;
+}
+
+// Licznik bitu liczy 0, 1, 2, 3, 0 - przejscie stanu przy powrocie do 0
+// z probka wciaz rozna od stanu, czyli po czwartej z rzedu
+uint8_t przyciski_probka(przyciski_t *p, uint16_t port, przyciski_zdarzenia_t *z)
+{
+    uint16_t rozne = (~port & p->maska) ^ p->stan;
+    uint16_t przejscia;
+
+    p->c1 = (p->c1 ^ p->c0) & rozne;
+    p->c0 = ~p->c0 & rozne;
+    przejscia = rozne & ~(p->c0 | p->c1);
+    p->stan ^= przejscia;
+
+    z->wcisniete = przejscia & p->stan;
+    z->puszczone = przejscia & ~p->stan;
+    z->dlugie = 0;
+    z->powtorzenia = 0;
+
+    // Nowy uklad wcisnietych albo wszystkie puszczone - trzymanie od nowa
+    if (przejscia || p->stan == 0) {
+        p->trzymane = 0;
+        p->okres = POWTORZ;
+    } else if (++p->trzymane == DLUGO) {
+        z->dlugie = p->stan;
+        z->powtorzenia = p->stan;
+    } else if (p->trzymane == DLUGO + p->okres) {
+        z->powtorzenia = p->stan;
+        p->trzymane = DLUGO;
+        p->okres -= p->okres >> 2;
+        if (p->okres < POWTORZ_MIN) {
+            p->okres = POWTORZ_MIN;
+        }
+    }
+
+    return (przejscia | z->powtorzenia) != 0;
+}
+
+// Nic nie wcisniete i zaden licznik nie liczy - mozna przestac probkowac
+// i czekac na przerwanie CN
+uint8_t przyciski_spokoj(const przyciski_t *p)
+{
+    return (p->stan | p->c0 | p->c1) == 0;
+}
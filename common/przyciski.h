@@ -0,0 +1,65 @@
+/*
+ * File:   przyciski.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Debouncing wszystkich 16 bitow portu naraz - liczniki pionowe.
+ *
+ * Kazdy bit portu ma 2-bitowy licznik probek roznych od stanu ustalonego,
+ * ale bity licznikow leza w dwoch slowach (c0 - mlodsze bity licznikow
+ * wszystkich przyciskow, c1 - starsze), wiec probka to kilka operacji
+ * XOR/AND na slowach, niezaleznie od liczby przyciskow. Stan bitu zmienia
+ * sie po PRZYCISKI_PROBKI kolejnych probkach roznych od niego, probka
+ * rowna stanowi zeruje licznik. Probki co PRZYCISKI_OKRES_US - z timera
+ * albo zegara programowego, tylko z jednego miejsca.
+ *
+ * Przyciski zwieraja do masy (wcisniety = 0 w porcie), w stanie i
+ * zdarzeniach wcisniety to 1. Zdarzenia sa maskami bitow portu:
+ * wcisniecie, puszczenie, dlugie przytrzymanie (po PRZYCISKI_DLUGO_MS
+ * bez zmiany wcisnietych) i autopowtarzanie - pierwsze razem z dlugim,
+ * potem coraz czesciej (okres krotszy o 1/4, az do PRZYCISKI_POWTORZ_MIN_MS).
+ * Czas trzymania liczy jeden licznik dla calego ukladu wcisnietych, wiec
+ * tez nie zalezy od liczby przyciskow.
+ */
+
+#ifndef PRZYCISKI_H
+#define PRZYCISKI_H
+
+#include <stdint.h>
+#include "taktowanie.h"
+
+// 4 probki (2-bitowy licznik) na DEBOUNCE_MS
+#define PRZYCISKI_PROBKI        4
+#define PRZYCISKI_OKRES_US      (DEBOUNCE_MS * 1000UL / PRZYCISKI_PROBKI)
+
+#define PRZYCISKI_DLUGO_MS          500
+#define PRZYCISKI_POWTORZ_MS        250     // pierwszy odstep po dlugim
+#define PRZYCISKI_POWTORZ_MIN_MS    25
+
+// Czas w ms -> liczba probek
+#define PRZYCISKI_PROBEK(ms)    ((uint16_t)((ms) * 1000UL / PRZYCISKI_OKRES_US))
+
+typedef struct {
+    uint16_t wcisniete;
+    uint16_t puszczone;
+    uint16_t dlugie;
+    uint16_t powtorzenia;
+} przyciski_zdarzenia_t;
+
+typedef struct {
+    uint16_t maska;             // bity portu z przyciskami
+    uint16_t stan;              // po debouncingu, 1 - wcisniety
+    uint16_t c0, c1;            // liczniki pionowe
+    uint16_t trzymane;          // probki bez zmiany wcisnietych
+    uint16_t okres;             // biezacy odstep powtorzen (probki)
+} przyciski_t;
+
+#if PRZYCISKI_POWTORZ_MIN_MS * 1000UL < PRZYCISKI_OKRES_US
+#error "PRZYCISKI_POWTORZ_MIN_MS krotszy niz okres probkowania"
+#endif
+
+void przyciski_init(przyciski_t *p, uint16_t maska);   // wszystkie puszczone
+// Jedna probka portu - 1, gdy jest jakies zdarzenie
+uint8_t przyciski_probka(przyciski_t *p, uint16_t port, przyciski_zdarzenia_t *z);
+uint8_t przyciski_spokoj(const przyciski_t *p);         // puszczone i ustalone
+
+#endif // PRZYCISKI_H
@@ -0,0 +1,63 @@
+/*
+ * File:   sekwencja.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Blokada sekwencyjna (seqlock) - spojna kopia kilku slow zapisywanych
+ * w przerwaniu, bez wylaczania przerwan.
+ *
+ * Piszacy (jedno przerwanie albo kilka o tym samym priorytecie) zwieksza
+ * licznik przed i po zapisie bloku, wiec w trakcie zapisu jest nieparzysty.
+ * Czytajacy (petla glowna albo przerwanie o nizszym priorytecie) kopiuje
+ * blok i powtarza kopie, gdy licznik byl nieparzysty albo sie zmienil:
+ *
+ *     do {
+ *         w = sekwencja_odczyt(&sekw);
+ *         kopia = blok;
+ *     } while (sekwencja_ponow(&sekw, w));
+ *
+ * Piszacy nigdy nie czeka, czytajacy powtarza najwyzej tyle razy, ile
+ * zapisow trafilo w jego kopie. Licznik przy okazji numeruje zapisy -
+ * rozny od ostatnio widzianego znaczy "cos nowego" (16-bit, odczyt
+ * jednym rozkazem). Piszacy o nizszym priorytecie niz czytajacy
+ * zakleszczylby czytajacego na nieparzystym liczniku - tego nie wolno.
+ */
+
+#ifndef SEKWENCJA_H
+#define SEKWENCJA_H
+
+#include <stdint.h>
+
+typedef volatile uint16_t sekwencja_t;
+
+// Kompilator nie przeniesie dostepow do pamieci przez bariere
+#define SEKWENCJA_BARIERA()     __asm__ volatile ("" ::: "memory")
+
+// Piszacy - przed i po zapisie bloku
+static inline void sekwencja_zapis(sekwencja_t *s)
+{
+    (*s)++;
+    SEKWENCJA_BARIERA();
+}
+
+static inline void sekwencja_koniec(sekwencja_t *s)
+{
+    SEKWENCJA_BARIERA();
+    (*s)++;
+}
+
+// Czytajacy - numer przed kopia i sprawdzenie po niej
+static inline uint16_t sekwencja_odczyt(const sekwencja_t *s)
+{
+    uint16_t w = *s;
+
+    SEKWENCJA_BARIERA();
+    return w;
+}
+
+static inline uint8_t sekwencja_ponow(const sekwencja_t *s, uint16_t w)
+{
+    SEKWENCJA_BARIERA();
+    return (w & 1) || *s != w;
+}
+
+#endif // SEKWENCJA_H
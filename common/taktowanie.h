@@ -0,0 +1,80 @@
+/*
+ * File:   taktowanie.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Wspolna konfiguracja zegara dla wszystkich projektow (zad_1 - zad_5) i lcd.c.
+ * Wszystkie stale czasowe sa liczone z jednej definicji FOSC, wiec zmiana
+ * zegara to zmiana jednej linii. Niemozliwe wartosci zatrzymuja kompilacje.
+ */
+
+#ifndef TAKTOWANIE_H
+#define TAKTOWANIE_H
+
+// Oscylator: #pragma config FNOSC = FRC -> wewnetrzny FRC 8 MHz bez PLL
+// i bez dzielnika (RCDIV dotyczy tylko FRCDIV), Fcy = Fosc / 2
+#define FOSC                    8000000UL
+#define FCY                     (FOSC / 2)
+
+// Nazwa uzywana przez biblioteke LCD (Microchip)
+#define SYSTEM_PERIPHERAL_CLOCK FCY
+
+// Liczba cykli Tcy na podany czas
+#define CYKLE_US(us)            ((FCY / 1000000UL) * (us))
+#define CYKLE_MS(ms)            ((FCY / 1000UL) * (ms))
+
+// Okres timera (wartosc PRx) dla danego preskalera i czasu w us.
+// Najpierw mnozenie - FCY / preskaler nie musi byc wielokrotnoscia 1 kHz
+#define TIMER_PR(preskaler, us) ((FCY / 1000000UL) * (us) / (preskaler) - 1)
+
+// Czy okres miesci sie w 16-bitowym PRx (zero impulsow daje -1, wiec tez
+// nie) - kazdy okres ze stalych sprawdza sie przy definicji:
+// #if !TIMER_PR_OK(8, OKRES_US) / #error
+#define TIMER_PR_OK(preskaler, us) (TIMER_PR(preskaler, us) <= 0xFFFFUL)
+
+// ADC: Tad = (ADCS + 1) * Tcy, minimum wg noty katalogowej 75 ns.
+// Domyslnie 16 us i probkowanie 31 Tad - wolno, ale pewnie dla
+// potencjometru na Explorer16 (tak jak wczesniej AD1CON3 = 0x1F3F przy 4 MHz)
+#define ADC_TAD_NS              16000UL
+#define ADC_SAMC                31
+#define ADC_ADCS                ADC_ADCS_DLA(ADC_TAD_NS)
+#define ADC_AD1CON3             ((ADC_SAMC << 8) | ADC_ADCS)
+
+// Szybki wariant dla akwizycji w tle (wyzwalanie timerem, SAMC nie gra
+// roli): konwersja 12 Tad = 6 us zamiast 192 us, kosztem wiekszego szumu
+#define ADC_TAD_SZYBKO_NS       500UL
+#define ADC_SAMC_SZYBKO         2
+#define ADC_ADCS_SZYBKO         ADC_ADCS_DLA(ADC_TAD_SZYBKO_NS)
+#define ADC_AD1CON3_SZYBKO      ((ADC_SAMC_SZYBKO << 8) | ADC_ADCS_SZYBKO)
+
+#define ADC_ADCS_DLA(tad_ns)    ((FCY / 1000UL) * (tad_ns) / 1000000UL - 1)
+
+// Debouncing przyciskow
+#define DEBOUNCE_MS             10
+#define DEBOUNCE_CYKLE          CYKLE_MS(DEBOUNCE_MS)
+
+// Sprawdzenie poprawnosci ustawien w czasie kompilacji
+#if (FCY % 1000000UL) != 0
+#error "FCY musi byc wielokrotnoscia 1 MHz (CYKLE_US)"
+#endif
+
+#if ADC_ADCS > 255
+#error "ADC_TAD_NS nie do ustawienia przy tym FCY (ADCS poza 0..255)"
+#endif
+
+#if (ADC_TAD_NS < 75) || ((ADC_ADCS + 1) * 1000000000UL / FCY < 75)
+#error "Tad ponizej 75 ns - przetwornik nie zdazy z konwersja"
+#endif
+
+#if ADC_ADCS_SZYBKO > 255
+#error "ADC_TAD_SZYBKO_NS nie do ustawienia przy tym FCY (ADCS poza 0..255)"
+#endif
+
+#if (ADC_ADCS_SZYBKO + 1) * 1000000000UL / FCY < 75
+#error "Szybki Tad ponizej 75 ns - przetwornik nie zdazy z konwersja"
+#endif
+
+#if (ADC_SAMC < 1) || (ADC_SAMC > 31)
+#error "ADC_SAMC musi byc w zakresie 1..31 Tad"
+#endif
+
+#endif // TAKTOWANIE_H
@@ -0,0 +1,115 @@
+/*
+ * File:   trend.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Analiza trendu w oknie probek - opis w trend.h.
+ */
+
+#include "trend.h"
+
+#define MASKA               (TREND_OKNO - 1)
+
+// Probka z konca kolejki (najnowsza w kolejce)
+static uint16_t ostatnia(const trend_t *t, const trend_kolejka_t *k)
+{
+    return t->probki[k->numery[(k->poczatek + k->dlugosc - 1) & MASKA] & MASKA];
+}
+
+// Najstarsza probka okna wychodzi - takze z poczatku kolejki, jesli tam jest
+static void wygas(trend_kolejka_t *k, uint8_t numer)
+{
+    if (k->dlugosc && k->numery[k->poczatek] == numer) {
+        k->poczatek = (k->poczatek + 1) & MASKA;
+        k->dlugosc--;
+    }
+}
+
+static void dopisz(trend_kolejka_t *k, uint8_t numer)
+{
+    k->numery[(k->poczatek + k->dlugosc) & MASKA] = numer;
+    k->dlugosc++;
+}
+
+void trend_init(trend_t *t)
+{
+    t->pelny = 0;
+}
+
+void trend_probka(trend_t *t, uint16_t y)
+{
+    uint8_t i = t->numer & MASKA;
+    uint16_t stara;
+
+    // Pierwsza probka - cale okno rowne y, jakby przyszly ostatnie
+    // TREND_OKNO probki (numery numer - TREND_OKNO .. numer - 1)
+    if (!t->pelny) {
+        uint8_t j;
+
+        for (j = 0; j < TREND_OKNO; j++) {
+            t->probki[j] = y;
+        }
+        t->suma = (uint32_t)y * TREND_OKNO;
+        t->suma_xy = (int32_t)y * (TREND_OKNO * (TREND_OKNO - 1) / 2);
+        t->max.poczatek = t->min.poczatek = 0;
+        t->max.dlugosc = t->min.dlugosc = 1;
+        t->max.numery[0] = t->min.numery[0] = (uint8_t)(t->numer - 1);
+        t->pelny = 1;
+    }
+
+    // Najstarsza probka (numer - TREND_OKNO) wychodzi z okna i kolejek
+    stara = t->probki[i];
+    wygas(&t->max, (uint8_t)(t->numer - TREND_OKNO));
+    wygas(&t->min, (uint8_t)(t->numer - TREND_OKNO));
+
+    t->suma_xy -= (int32_t)(t->suma - stara);
+    t->suma_xy += (int32_t)y * (TREND_OKNO - 1);
+    t->suma += y;
+    t->suma -= stara;
+    t->probki[i] = y;
+
+    while (t->max.dlugosc && ostatnia(t, &t->max) <= y) {
+        t->max.dlugosc--;
+    }
+    dopisz(&t->max, t->numer);
+    while (t->min.dlugosc && ostatnia(t, &t->min) >= y) {
+        t->min.dlugosc--;
+    }
+    dopisz(&t->min, t->numer);
+
+    t->numer++;
+}
+
+// Licznik nachylenia z regresji: N * Sxy - Sx * Sy = N/2 * (2 * Sxy - (N - 1) * Sy),
+// mianownik N^2 (N^2 - 1) / 12 skrocony o N/2 to TREND_K
+int32_t trend_nachylenie(const trend_t *t)
+{
+    return 2 * t->suma_xy - (int32_t)(TREND_OKNO - 1) * (int32_t)t->suma;
+}
+
+uint16_t trend_min(const trend_t *t)
+{
+    return t->probki[t->min.numery[t->min.poczatek] & MASKA];
+}
+
+uint16_t trend_max(const trend_t *t)
+{
+    return t->probki[t->max.numery[t->max.poczatek] & MASKA];
+}
+
+// (prog - max) / (l / K) < horyzont  <=>  (prog - max) * K < horyzont * l
+// dla l > 0 - iloczyny zamiast dzielenia
+uint8_t trend_prognoza(const trend_t *t, uint16_t prog, uint16_t horyzont)
+{
+    return trend_prognoza_z(trend_nachylenie(t), trend_max(t), prog, horyzont);
+}
+
+uint8_t trend_prognoza_z(int32_t l, uint16_t max, uint16_t prog, uint16_t horyzont)
+{
+    if (l <= 0) {
+        return 0;               // spadek - maksimum okna to juz przeszlosc
+    }
+    if (max >= prog) {
+        return 1;
+    }
+    return (int64_t)(prog - max) * TREND_K < (int64_t)horyzont * l;
+}
@@ -0,0 +1,67 @@
+/*
+ * File:   trend.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Analiza trendu strumienia probek (np. wynikow ADC) w oknie TREND_OKNO
+ * ostatnich probek - stala praca na probke i bez dzielenia, wiec mozna ja
+ * wolac w przerwaniu ADC przy kazdej nowej wartosci.
+ *
+ * Nachylenie to regresja liniowa z sum biegnacych: suma y i suma x*y, gdzie
+ * x = 0 dla najstarszej probki. Przy przesunieciu okna kazda probka
+ * starzeje sie o 1, wiec suma x*y maleje o sume y bez najstarszej, a nowa
+ * dochodzi z x = TREND_OKNO - 1. Mianownik regresji jest staly, stad
+ * nachylenie = trend_nachylenie() / TREND_K (jednostek na probke).
+ *
+ * Minimum i maksimum okna daja kolejki monotoniczne: z konca wypadaja
+ * probki, ktore przy nowej juz nigdy nie beda ekstremum, z poczatku -
+ * te, ktore wyszly z okna (kazda probka wchodzi i wychodzi raz).
+ *
+ * Pierwsza probka wypelnia cale okno, wiec nie ma pozornego trendu od zera.
+ */
+
+#ifndef TREND_H
+#define TREND_H
+
+#include <stdint.h>
+
+#ifndef TREND_OKNO_BITY
+#define TREND_OKNO_BITY         7               // 128 probek
+#endif
+#define TREND_OKNO              (1u << TREND_OKNO_BITY)
+
+// Mianownik nachylenia: N * (N^2 - 1) / 6 dla okna N probek
+#define TREND_K                 ((int32_t)TREND_OKNO * ((int32_t)TREND_OKNO * TREND_OKNO - 1) / 6)
+
+// Numery probek sa 8-bitowe, a sumy 32-bitowe dla probek do 12 bitow
+#if TREND_OKNO_BITY < 2 || TREND_OKNO_BITY > 7
+#error "TREND_OKNO_BITY musi byc w zakresie 2..7"
+#endif
+
+typedef struct {
+    uint8_t numery[TREND_OKNO];     // numery probek, wartosci monotoniczne
+    uint8_t poczatek, dlugosc;
+} trend_kolejka_t;
+
+typedef struct {
+    uint16_t probki[TREND_OKNO];    // pierscien, probka n w [n % TREND_OKNO]
+    uint32_t suma;                  // suma y
+    int32_t suma_xy;                // suma x * y
+    trend_kolejka_t max, min;
+    uint8_t numer;                  // numer nastepnej probki
+    uint8_t pelny;                  // 0 - czeka na pierwsza probke
+} trend_t;
+
+void trend_init(trend_t *t);
+void trend_probka(trend_t *t, uint16_t y);
+
+int32_t trend_nachylenie(const trend_t *t);     // nachylenie * TREND_K
+uint16_t trend_min(const trend_t *t);
+uint16_t trend_max(const trend_t *t);
+
+// Czy przy obecnym (dodatnim) nachyleniu maksimum okna dojdzie do progu
+// w ciagu horyzont probek - takze gdy juz go przekroczylo
+uint8_t trend_prognoza(const trend_t *t, uint16_t prog, uint16_t horyzont);
+// To samo z zapamietanego nachylenia i maksimum (np. kopii z przerwania)
+uint8_t trend_prognoza_z(int32_t nachylenie, uint16_t max, uint16_t prog, uint16_t horyzont);
+
+#endif // TREND_H
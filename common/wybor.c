@@ -0,0 +1,140 @@
+/*
+ * File:   wybor.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Wybor opcji potencjometrem w tle - opis w wybor.h.
+ */
+
+#include <xc.h>
+#include "wybor.h"
+#include "pomiar.h"
+
+#define ZAKRES              (16u * 1024)        // suma 16 probek 10-bitowych
+
+static uint8_t ile_opcji;
+static uint16_t pasmo;                          // szerokosc pasma jednej opcji
+static uint16_t histereza;
+
+static volatile uint8_t wybrana;
+static volatile uint16_t zmiany;                // licznik zmian (przerwanie)
+static uint16_t zmiany_widziane;                // ... juz zgloszonych
+static uint8_t kandydat, potwierdzenia;
+static uint32_t filtr;                          // suma << WYBOR_FILTR
+static uint8_t pierwszy;
+
+void wybor_init(uint8_t ile, uint8_t poczatkowa)
+{
+    ile_opcji = ile;
+    wybrana = poczatkowa < ile ? poczatkowa : 0;
+    pasmo = ZAKRES / ile;                       // jedyne dzielenie - raz
+    histereza = pasmo / WYBOR_HISTEREZA;
+
+    AD1PCFG &= ~(1u << WYBOR_KANAL);            // wejscie analogowe
+    AD1CON1 = 0;
+    AD1CON1bits.SSRC = 0b111;                   // licznik SAMC konczy probkowanie
+    AD1CON1bits.ASAM = 1;                       // i od razu nastepna probka
+    AD1CON2 = 0;
+    AD1CON2bits.SMPI = 15;                      // przerwanie co 16 probek
+    AD1CON3 = WYBOR_AD1CON3;
+    AD1CHS = WYBOR_KANAL;
+
+    IPC3bits.AD1IP = WYBOR_PRIORYTET;
+    IFS0bits.AD1IF = 0;
+    IEC0bits.AD1IE = 1;
+}
+
+void wybor_start(void)
+{
+    pierwszy = 1;
+    potwierdzenia = 0;
+    AD1CON1bits.ADON = 1;
+}
+
+void wybor_stop(void)
+{
+    AD1CON1bits.ADON = 0;
+    IFS0bits.AD1IF = 0;
+}
+
+// Przerwanie tylko zwieksza licznik, petla glowna tylko go czyta (jeden
+// rozkaz) - bez kasowania flagi, ktore musialoby wylaczac przerwania
+uint8_t wybor_zmiana(void)
+{
+    uint16_t z = zmiany;
+
+    if (z == zmiany_widziane) {
+        return 0;
+    }
+    zmiany_widziane = z;
+    return 1;
+}
+
+uint8_t wybor_indeks(void)
+{
+    return wybrana;
+}
+
+// Opcja dla wartosci v: od biezacej w strone v, pasmo po pasmie. Granica
+// z sasiadem przesunieta o h na jego niekorzysc (h = 0 - zwykle pasma)
+static uint8_t opcja_dla(uint16_t v, uint16_t h)
+{
+    uint8_t k = wybrana;
+
+    while (k + 1 < ile_opcji && v >= (uint16_t)(k + 1) * pasmo + h) {
+        k++;
+    }
+    while (k > 0 && v + h < (uint16_t)k * pasmo) {
+        k--;
+    }
+    return k;
+}
+
+// Czas wykonania przerwania ADC (pomiar.h) - do podgladu w debuggerze
+pomiar_t pomiar_wyboru;
+
+// Suma 16 probek z przerwania ADC - filtr i wybor opcji
+static void nowa_suma(uint16_t suma)
+{
+    uint8_t k;
+
+    // Pierwszy pomiar po starcie - bez dochodzenia filtru od zera i bez
+    // histerezy, bo galka mogla sie ruszyc, gdy ADC stal
+    if (pierwszy) {
+        filtr = (uint32_t)suma << WYBOR_FILTR;
+        k = opcja_dla(suma, 0);
+        pierwszy = 0;
+        if (k != wybrana) {
+            wybrana = k;
+            zmiany++;
+        }
+        return;
+    }
+    filtr = filtr - (filtr >> WYBOR_FILTR) + suma;
+
+    k = opcja_dla((uint16_t)(filtr >> WYBOR_FILTR), histereza);
+    if (k == wybrana) {
+        potwierdzenia = 0;
+    } else if (potwierdzenia == 0 || k != kandydat) {
+        kandydat = k;
+        potwierdzenia = 1;
+    } else if (++potwierdzenia >= WYBOR_POTWIERDZENIA) {
+        wybrana = k;
+        zmiany++;
+        potwierdzenia = 0;
+    }
+}
+
+void __attribute__((interrupt, no_auto_psv)) _ADC1Interrupt(void)
+{
+    POMIAR_START();
+    volatile uint16_t *bufor = &ADC1BUF0;
+    uint16_t suma = 0;
+    uint8_t i;
+
+    IFS0bits.AD1IF = 0;
+    for (i = 0; i < 16; i++) {
+        suma += bufor[i];
+    }
+    nowa_suma(suma);
+    POMIAR_KONIEC(pomiar_wyboru);
+}
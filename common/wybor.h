@@ -0,0 +1,48 @@
+/*
+ * File:   wybor.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Wybor jednej z opcji potencjometrem, bez pracy w petli glownej.
+ *
+ * ADC mierzy w tle (auto-probkowanie i auto-konwersja, najwolniejszy Tad)
+ * i zglasza przerwanie co 16 probek, ok. 23 razy na sekunde. Przerwanie
+ * sumuje probki (14 bitow), filtruje srednia wykladnicza i dzieli zakres
+ * na rowne pasma, po jednym na opcje. Zmiana opcji wymaga wyjscia poza
+ * pasmo biezacej o WYBOR_HISTEREZA pasma i utrzymania nowej przez
+ * WYBOR_POTWIERDZENIA kolejnych pomiarow - galka na granicy nie przelacza
+ * wyboru w kolko. Na zewnatrz trafia tylko zdarzenie "wybor sie zmienil".
+ *
+ * Opcje to indeksy 0..ile-1 - co znacza (tablica czasow, napisy), zostaje
+ * w projekcie. Zajete: ADC1 i jego przerwanie.
+ */
+
+#ifndef WYBOR_H
+#define WYBOR_H
+
+#include <stdint.h>
+#include "taktowanie.h"
+
+#ifndef WYBOR_KANAL
+#define WYBOR_KANAL             5               // AN5 - potencjometr Explorer16
+#endif
+#define WYBOR_FILTR             2               // srednia wykladnicza 1/4
+#define WYBOR_HISTEREZA         4               // 1/4 szerokosci pasma
+#define WYBOR_POTWIERDZENIA     3               // pomiary z nowa opcja (ok. 130 ms)
+#define WYBOR_PRIORYTET         2
+
+// Tad 64 us i probkowanie 31 Tad - 2,75 ms na probke
+#define WYBOR_TAD_NS            64000UL
+#define WYBOR_AD1CON3           ((31 << 8) | ADC_ADCS_DLA(WYBOR_TAD_NS))
+
+#if ADC_ADCS_DLA(WYBOR_TAD_NS) > 255
+#error "WYBOR_TAD_NS nie do ustawienia przy tym FCY (ADCS poza 0..255)"
+#endif
+
+void wybor_init(uint8_t ile, uint8_t poczatkowa);
+void wybor_start(void);                 // pomiary w tle
+void wybor_stop(void);                  // ADC wylaczony, wybor zostaje
+
+uint8_t wybor_zmiana(void);             // czy wybor sie zmienil od ostatniego pytania
+uint8_t wybor_indeks(void);
+
+#endif // WYBOR_H
@@ -0,0 +1,191 @@
+/*
+ * File:   zegary.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Kolo zegarow programowych - opis w zegary.h.
+ */
+
+#include "zegary.h"
+
+#define MASKA               (ZEGARY_PRZEGRODKI - 1)
+#define PRZEGRODKA(t)       ((uint8_t)((t) >> ZEGAR_TIK_BITY) & MASKA)
+
+static zegar_t *kolo[ZEGARY_PRZEGRODKI];
+static uint16_t mapa[ZEGARY_PRZEGRODKI / 16];  // bit = niepusta przegrodka
+static czas_t tik;                              // poczatek biezacego tiku
+
+static void wstaw(zegar_t *z)
+{
+    // Termin sprzed biezacego tiku (zalegly zegar okresowy) - do biezacej
+    // przegrodki, inaczej czekalby caly obrot kola
+    uint8_t p = PRZEGRODKA((int32_t)(z->termin - tik) < 0 ? tik : z->termin);
+
+    z->nastepny = kolo[p];
+    z->przegrodka = p;
+    z->aktywny = 1;
+    kolo[p] = z;
+    mapa[p >> 4] |= 1u << (p & 15);
+}
+
+static void wyjmij(zegar_t *z)
+{
+    uint8_t p = z->przegrodka;
+    zegar_t **pz = &kolo[p];
+
+    while (*pz != z) {
+        pz = &(*pz)->nastepny;
+    }
+    *pz = z->nastepny;
+    z->aktywny = 0;
+    if (kolo[p] == NULL) {
+        mapa[p >> 4] &= ~(1u << (p & 15));
+    }
+}
+
+// Odleglosc od p do najblizszej niepustej przegrodki, wiecej niz n gdy
+// w zasiegu n przegrodek nie ma zadnej. Puste slowa mapy sa pomijane w calosci
+static uint8_t nastepna_zajeta(uint8_t p, uint8_t n)
+{
+    uint8_t d = 0;
+
+    while (d <= n) {
+        uint8_t q = (p + d) & MASKA;
+        uint16_t slowo = mapa[q >> 4] >> (q & 15);
+
+        if (slowo == 0) {
+            d += 16 - (q & 15);
+        } else if (slowo & 1) {
+            return d;
+        } else {
+            d++;
+        }
+    }
+    return d;
+}
+
+static void obsluz_przegrodke(uint8_t p, czas_t teraz)
+{
+    zegar_t *z = kolo[p];
+
+    while (z != NULL) {
+        if (!CZAS_MINAL(teraz, z->termin)) {
+            z = z->nastepny;    // dalszy obrot kola albo jeszcze ten tik
+            continue;
+        }
+        wyjmij(z);
+        if (z->okres) {
+            z->termin += z->okres;
+            wstaw(z);
+        }
+        z->zdarzenie = 1;
+        if (z->akcja != NULL) {
+            z->akcja();
+        }
+        z = kolo[p];            // akcja mogla zmienic listy - od poczatku
+    }
+}
+
+void zegary_init(void)
+{
+    tik = czas_teraz() & ~(ZEGAR_TIK - 1);
+}
+
+void zegar_start(zegar_t *z, czas_t za, czas_t okres)
+{
+    zegar_start_w(z, czas_teraz() + za, okres);
+}
+
+// Termin moze juz minac - zegar zadziala w najblizszym zegary_obsluz(),
+// a okresowy dalej liczy od tego terminu, nie od chwili startu
+void zegar_start_w(zegar_t *z, czas_t termin, czas_t okres)
+{
+    if (z->aktywny) {
+        wyjmij(z);
+    }
+    z->termin = termin;
+    z->okres = okres;
+    z->zdarzenie = 0;
+    wstaw(z);
+}
+
+void zegar_stop(zegar_t *z)
+{
+    if (z->aktywny) {
+        wyjmij(z);
+    }
+    z->zdarzenie = 0;
+}
+
+uint8_t zegar_zdarzenie(zegar_t *z)
+{
+    uint8_t bylo = z->zdarzenie;
+
+    z->zdarzenie = 0;
+    return bylo;
+}
+
+// Przegrodki tikow, ktore minely od poprzedniego wywolania, i biezacego -
+// po dluzszej przerwie najwyzej jeden obrot kola
+void zegary_obsluz(void)
+{
+    czas_t teraz = czas_teraz();
+    czas_t minelo = (teraz - tik) >> ZEGAR_TIK_BITY;
+    uint8_t n = minelo < ZEGARY_PRZEGRODKI ? (uint8_t)minelo : ZEGARY_PRZEGRODKI - 1;
+    uint8_t p = PRZEGRODKA(tik);
+    uint8_t d;
+
+    // Najpierw nowy tik - zegary wstawiane przez akcje licza sie juz od niego
+    tik += minelo << ZEGAR_TIK_BITY;
+
+    for (d = 0; d <= n; d++) {
+        d += nastepna_zajeta((p + d) & MASKA, n - d);
+        if (d > n) {
+            break;
+        }
+        obsluz_przegrodke((p + d) & MASKA, teraz);
+    }
+}
+
+// Budzik na najwczesniejszy zegar z pierwszej niepustej przegrodki, ktora
+// ma zegar z tego obrotu kola. Przegladanie wszystkich zegarow tylko wtedy,
+// gdy caly obrot (ok. 65 ms) jest pusty
+void zegary_budzik(void)
+{
+    uint8_t p = PRZEGRODKA(tik);
+    uint8_t d;
+    zegar_t *z;
+    zegar_t *najblizszy = NULL;
+
+    for (d = 0; d < ZEGARY_PRZEGRODKI; d++) {
+        czas_t poczatek;
+
+        d += nastepna_zajeta((p + d) & MASKA, ZEGARY_PRZEGRODKI - 1 - d);
+        if (d >= ZEGARY_PRZEGRODKI) {
+            break;
+        }
+        poczatek = tik + ((czas_t)d << ZEGAR_TIK_BITY);
+        for (z = kolo[(p + d) & MASKA]; z != NULL; z = z->nastepny) {
+            if ((int32_t)(z->termin - poczatek) < (int32_t)ZEGAR_TIK &&
+                (najblizszy == NULL || (int32_t)(z->termin - najblizszy->termin) < 0)) {
+                najblizszy = z;
+            }
+        }
+        if (najblizszy != NULL) {
+            czas_budzik(najblizszy->termin);
+            return;
+        }
+    }
+
+    for (p = 0; p < ZEGARY_PRZEGRODKI; p++) {
+        for (z = kolo[p]; z != NULL; z = z->nastepny) {
+            if (najblizszy == NULL || (int32_t)(z->termin - najblizszy->termin) < 0) {
+                najblizszy = z;
+            }
+        }
+    }
+    if (najblizszy != NULL) {
+        czas_budzik(najblizszy->termin);
+    } else {
+        czas_budzik_wylacz();   // brak zegarow - budza tylko przerwania
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * File:   zegary.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Zegary programowe (jednorazowe i okresowe) na podstawie czasu z czas.h.
+ *
+ * Zegary sa w kole haszujacym: ZEGARY_PRZEGRODKI przegrodek po ZEGAR_TIK
+ * (ok. 1 ms), przegrodka = bity terminu, wiec bez dzielenia. Mapa bitowa
+ * zajetych przegrodek pozwala przeskoczyc puste, a koszt jednego tiku nie
+ * zalezy od liczby zegarow. Termin jest bezwzgledny (czas_t), wiec zegar
+ * dalszy niz jeden obrot kola po prostu czeka w przegrodce na swoj obrot,
+ * a zegar okresowy nie dryfuje (termin += okres).
+ *
+ * Po terminie zegar ustawia flage zdarzenia (zegar_zdarzenie) i wywoluje
+ * akcje, jesli ja ma. Wszystko dzieje sie w zegary_obsluz() w petli glownej
+ * - funkcji z tego pliku nie wolno wolac z przerwan.
+ */
+
+#ifndef ZEGARY_H
+#define ZEGARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "czas.h"
+
+#define ZEGARY_PRZEGRODKI       64              // potega 2, wielokrotnosc 16
+#define ZEGAR_TIK_BITY          9               // tik = 512 impulsow = 1,024 ms
+#define ZEGAR_TIK               ((czas_t)1 << ZEGAR_TIK_BITY)
+
+typedef void (*zegar_akcja_t)(void);
+
+typedef struct zegar {
+    struct zegar *nastepny;     // lista w przegrodce
+    czas_t termin;
+    czas_t okres;               // 0 - jednorazowy
+    zegar_akcja_t akcja;        // NULL - tylko flaga zdarzenia
+    uint8_t przegrodka;         // w ktorej liscie jest
+    uint8_t aktywny;
+    uint8_t zdarzenie;
+} zegar_t;
+
+// zegar_t z = ZEGAR(akcja);  albo  ZEGAR(NULL) dla samej flagi
+#define ZEGAR(akcja)            { NULL, 0, 0, (akcja), 0, 0, 0 }
+
+#if (ZEGARY_PRZEGRODKI & (ZEGARY_PRZEGRODKI - 1)) || (ZEGARY_PRZEGRODKI % 16)
+#error "ZEGARY_PRZEGRODKI musi byc potega 2 i wielokrotnoscia 16"
+#endif
+
+void zegary_init(void);                 // po czas_init()
+void zegar_start(zegar_t *z, czas_t za, czas_t okres);
+void zegar_start_w(zegar_t *z, czas_t termin, czas_t okres);   // termin bezwzgledny
+void zegar_stop(zegar_t *z);
+uint8_t zegar_zdarzenie(zegar_t *z);    // czy minal termin (i kasuje flage)
+
+void zegary_obsluz(void);               // zegary po terminie - w petli glownej
+void zegary_budzik(void);               // budzik na najblizszy termin (przy IPL 7)
+
+#endif // ZEGARY_H
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+# Generator include/p24FJ128GA010.h dla budowania na PC.
+#
+# Kazdy rejestr SFR jest makrem (*sim_sfr(SFR_X)), a pola bitowe strukturami
+# o ukladzie jak w naglowku XC16, wiec firmware kompiluje sie bez zmian.
+# sim_sfr() (sim.c) liczy czas i obsluguje skutki dostepu do rejestru.
+# Opisane sa tylko rejestry uzywane w projektach - nowy rejestr dopisac
+# do listy ponizej i uruchomic: python3 gen_sfr.py > include/p24FJ128GA010.h
+regs = [
+ # name, bits list [(name, pos, width)]
+ ("SR", [("C",0,1),("Z",1,1),("OV",2,1),("N",3,1),("RA",4,1),("IPL",5,3),("DC",8,1)]),
+ ("CORCON", [("PSV",2,1),("IPL3",3,1)]),
+ ("INTCON1", [("NSTDIS",15,1)]),
+ ("INTCON2", [("INT0EP",0,1),("INT1EP",1,1),("INT2EP",2,1),("DISI",14,1),("ALTIVT",15,1)]),
+ ("IFS0", [("INT0IF",0,1),("IC1IF",1,1),("OC1IF",2,1),("T1IF",3,1),("IC2IF",5,1),("OC2IF",6,1),("T2IF",7,1),("T3IF",8,1),("SPF1IF",9,1),("SPI1IF",10,1),("U1RXIF",11,1),("U1TXIF",12,1),("AD1IF",13,1)]),
+ ("IFS1", [("SI2C1IF",0,1),("MI2C1IF",1,1),("CMIF",2,1),("CNIF",3,1),("INT1IF",4,1),("IC7IF",6,1),("IC8IF",7,1),("OC3IF",9,1),("OC4IF",10,1),("T4IF",11,1),("T5IF",12,1),("INT2IF",13,1),("U2RXIF",14,1),("U2TXIF",15,1)]),
+ ("IFS2", [("SPF2IF",0,1),("SPI2IF",1,1),("IC3IF",5,1),("IC4IF",6,1),("IC5IF",7,1),("IC6IF",8,1),("OC5IF",9,1),("OC6IF",10,1),("OC7IF",11,1),("OC8IF",12,1),("PMPIF",13,1)]),
+ ("IEC0", [("INT0IE",0,1),("IC1IE",1,1),("OC1IE",2,1),("T1IE",3,1),("IC2IE",5,1),("OC2IE",6,1),("T2IE",7,1),("T3IE",8,1),("SPF1IE",9,1),("SPI1IE",10,1),("U1RXIE",11,1),("U1TXIE",12,1),("AD1IE",13,1)]),
+ ("IEC1", [("SI2C1IE",0,1),("MI2C1IE",1,1),("CMIE",2,1),("CNIE",3,1),("INT1IE",4,1),("IC7IE",6,1),("IC8IE",7,1),("OC3IE",9,1),("OC4IE",10,1),("T4IE",11,1),("T5IE",12,1),("INT2IE",13,1),("U2RXIE",14,1),("U2TXIE",15,1)]),
+ ("IEC2", [("SPF2IE",0,1),("SPI2IE",1,1),("IC3IE",5,1),("IC4IE",6,1),("IC5IE",7,1),("IC6IE",8,1),("OC5IE",9,1),("OC6IE",10,1),("OC7IE",11,1),("OC8IE",12,1),("PMPIE",13,1)]),
+ ("IPC0", [("INT0IP",0,3),("IC1IP",4,3),("OC1IP",8,3),("T1IP",12,3)]),
+ ("IPC1", [("IC2IP",4,3),("OC2IP",8,3),("T2IP",12,3)]),
+ ("IPC2", [("T3IP",0,3),("SPF1IP",4,3),("SPI1IP",8,3),("U1RXIP",12,3)]),
+ ("IPC3", [("U1TXIP",0,3),("AD1IP",4,3)]),
+ ("IPC4", [("SI2C1IP",0,3),("MI2C1IP",4,3),("CMIP",8,3),("CNIP",12,3)]),
+ ("IPC5", [("INT1IP",0,3),("IC7IP",8,3),("IC8IP",12,3)]),
+ ("IPC6", [("OC3IP",4,3),("OC4IP",8,3),("T4IP",12,3)]),
+ ("IPC7", [("T5IP",0,3),("INT2IP",4,3),("U2RXIP",8,3),("U2TXIP",12,3)]),
+ ("IPC8", [("SPF2IP",0,3),("SPI2IP",4,3)]),
+ ("IPC9", [("IC3IP",4,3),("IC4IP",8,3),("IC5IP",12,3)]),
+ ("IPC10", [("IC6IP",0,3),("OC5IP",4,3),("OC6IP",8,3),("OC7IP",12,3)]),
+ ("IPC11", [("OC8IP",0,3),("PMPIP",4,3)]),
+ ("CNEN1", [("CN%dIE"%i,i,1) for i in range(16)]),
+ ("CNEN2", [("CN%dIE"%(i+16),i,1) for i in range(6)]),
+ ("CNPU1", [("CN%dPUE"%i,i,1) for i in range(16)]),
+ ("CNPU2", [("CN%dPUE"%(i+16),i,1) for i in range(6)]),
+ ("T1CON", [("TCS",1,1),("TSYNC",2,1),("TCKPS",4,2),("TGATE",6,1),("TSIDL",13,1),("TON",15,1)]),
+ ("TMR1", None), ("PR1", None),
+ ("T2CON", [("TCS",1,1),("T32",3,1),("TCKPS",4,2),("TGATE",6,1),("TSIDL",13,1),("TON",15,1)]),
+ ("TMR2", None), ("TMR3HLD", None), ("TMR3", None), ("PR2", None), ("PR3", None),
+ ("T3CON", [("TCS",1,1),("TCKPS",4,2),("TGATE",6,1),("TSIDL",13,1),("TON",15,1)]),
+ ("T4CON", [("TCS",1,1),("T32",3,1),("TCKPS",4,2),("TGATE",6,1),("TSIDL",13,1),("TON",15,1)]),
+ ("TMR4", None), ("TMR5HLD", None), ("TMR5", None), ("PR4", None), ("PR5", None),
+ ("T5CON", [("TCS",1,1),("TCKPS",4,2),("TGATE",6,1),("TSIDL",13,1),("TON",15,1)]),
+]
+for i in range(1,9):
+    regs.append(("IC%dBUF"%i, None))
+    regs.append(("IC%dCON"%i, [("ICM",0,3),("ICBNE",3,1),("ICOV",4,1),("ICI",5,2),("ICTMR",7,1),("ICSIDL",13,1)]))
+regs += [
+ ("PMCON", [("RDSP",0,1),("WRSP",1,1),("BEP",2,1),("CS1P",3,1),("CS2P",4,1),("ALP",5,1),("CSF",6,2),("PTRDEN",8,1),("PTWREN",9,1),("PTBEEN",10,1),("ADRMUX",11,2),("PSIDL",13,1),("PMPEN",15,1)]),
+ ("PMMODE", [("WAITE",0,2),("WAITM",2,4),("WAITB",6,2),("MODE",8,2),("MODE16",10,1),("INCM",11,2),("IRQM",13,2),("BUSY",15,1)]),
+ ("PMADDR", None), ("PMDOUT1", None), ("PMDIN1", None), ("PMAEN", [("PTEN%d"%i,i,1) for i in range(16)]),
+ ("PMSTAT", [("OB0E",0,1),("OBUF",6,1),("OBE",7,1),("IB0F",8,1),("IBOV",14,1),("IBF",15,1)]),
+]
+for i in range(16): regs.append(("ADC1BUF%X"%i, None))
+regs += [
+ ("AD1CON1", [("DONE",0,1),("SAMP",1,1),("ASAM",2,1),("SSRC",5,3),("FORM",8,2),("ADSIDL",13,1),("ADON",15,1)]),
+ ("AD1CON2", [("ALTS",0,1),("BUFM",1,1),("SMPI",2,4),("BUFS",7,1),("CSCNA",10,1),("VCFG",13,3)]),
+ ("AD1CON3", [("ADCS",0,8),("SAMC",8,5),("ADRC",15,1)]),
+ ("AD1CHS", [("CH0SA",0,4),("CH0NA",7,1),("CH0SB",8,4),("CH0NB",15,1)]),
+ ("AD1PCFG", [("PCFG%d"%i,i,1) for i in range(16)]),
+ ("AD1CSSL", [("CSSL%d"%i,i,1) for i in range(16)]),
+ ("CMCON", [("C1POS",0,1),("C1NEG",1,1),("C2POS",2,1),("C2NEG",3,1),("C1INV",4,1),("C2INV",5,1),("C1OUT",6,1),("C2OUT",7,1),("C1OUTEN",8,1),("C2OUTEN",9,1),("C1EN",10,1),("C2EN",11,1),("C1EVT",12,1),("C2EVT",13,1),("CMIDL",15,1)]),
+ ("CVRCON", [("CVR",0,4),("CVRSS",4,1),("CVRR",5,1),("CVROE",6,1),("CVREN",7,1)]),
+]
+for p in "ABCDEFG":
+    regs.append(("TRIS"+p, [("TRIS%s%d"%(p,i),i,1) for i in range(16)]))
+    regs.append(("PORT"+p, [("R%s%d"%(p,i),i,1) for i in range(16)]))
+    regs.append(("LAT"+p, [("LAT%s%d"%(p,i),i,1) for i in range(16)]))
+regs += [
+ ("OSCCON", [("OSWEN",0,1),("SOSCEN",1,1),("CF",3,1),("LOCK",5,1),("CLKLOCK",7,1),("NOSC",8,3),("COSC",12,3)]),
+ ("CLKDIV", [("RCDIV",8,3),("DOZEN",11,1),("DOZE",12,3),("ROI",15,1)]),
+ ("PMD1", [("ADC1MD",0,1),("SPI1MD",3,1),("SPI2MD",4,1),("U1MD",5,1),("U2MD",6,1),("I2C1MD",7,1),("T1MD",11,1),("T2MD",12,1),("T3MD",13,1),("T4MD",14,1),("T5MD",15,1)]),
+ ("PMD2", [("IC%dMD"%(i+1),i,1) for i in range(8)] + [("OC%dMD"%(i+1),i+8,1) for i in range(8)]),
+ ("PMD3", [("I2C2MD",1,1),("CRCPMD",7,1),("PMPMD",8,1),("RTCCMD",9,1),("CMPMD",10,1)]),
+]
+out = []
+out.append("/* Wygenerowane przez host/gen_sfr.py - nie edytowac recznie */")
+out.append("#ifndef P24FJ128GA010_H")
+out.append("#define P24FJ128GA010_H")
+out.append("#include <stdint.h>")
+out.append("volatile uint16_t *sim_sfr(int r);")
+out.append("typedef enum {")
+for n,_ in regs: out.append("    SFR_%s," % n)
+out.append("    SFR_LICZBA")
+out.append("} sim_sfr_t;\n")
+for n,b in regs:
+    if b is None: continue
+    base = n
+    out.append("typedef struct {")
+    pos = 0
+    for (bn, bp, bw) in sorted(b, key=lambda x: x[1]):
+        if bp > pos:
+            out.append("    uint16_t :%d;" % (bp-pos))
+        out.append("    uint16_t %s:%d;" % (bn, bw))
+        pos = bp + bw
+    if pos < 16: out.append("    uint16_t :%d;" % (16-pos))
+    out.append("} %sBITS;" % n)
+out.append("")
+for n,b in regs:
+    out.append("#define %-10s (*sim_sfr(SFR_%s))" % (n, n))
+    if b is not None:
+        out.append("#define %-10s (*(volatile %sBITS *)sim_sfr(SFR_%s))" % (n+"bits", n, n))
+out.append("#endif")
+print("\n".join(out))
@@ -0,0 +1,19 @@
+/*
+ * File:   libpic30.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Zamiennik libpic30.h przy budowaniu na PC - opoznienia posuwaja
+ * wirtualny czas o podana liczbe cykli Tcy (sim.c).
+ */
+
+#ifndef LIBPIC30_H
+#define LIBPIC30_H
+
+#include <stdint.h>
+
+void __delay32(unsigned long cykle);
+
+#define __delay_us(us)  __delay32(CYKLE_US(us))
+#define __delay_ms(ms)  __delay32(CYKLE_MS(ms))
+
+#endif // LIBPIC30_H
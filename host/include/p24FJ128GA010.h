@@ -0,0 +1,1338 @@
+/* Wygenerowane przez host/gen_sfr.py - nie edytowac recznie */
+#ifndef P24FJ128GA010_H
+#define P24FJ128GA010_H
+#include <stdint.h>
+volatile uint16_t *sim_sfr(int r);
+typedef enum {
+    SFR_SR,
+    SFR_CORCON,
+    SFR_INTCON1,
+    SFR_INTCON2,
+    SFR_IFS0,
+    SFR_IFS1,
+    SFR_IFS2,
+    SFR_IEC0,
+    SFR_IEC1,
+    SFR_IEC2,
+    SFR_IPC0,
+    SFR_IPC1,
+    SFR_IPC2,
+    SFR_IPC3,
+    SFR_IPC4,
+    SFR_IPC5,
+    SFR_IPC6,
+    SFR_IPC7,
+    SFR_IPC8,
+    SFR_IPC9,
+    SFR_IPC10,
+    SFR_IPC11,
+    SFR_CNEN1,
+    SFR_CNEN2,
+    SFR_CNPU1,
+    SFR_CNPU2,
+    SFR_T1CON,
+    SFR_TMR1,
+    SFR_PR1,
+    SFR_T2CON,
+    SFR_TMR2,
+    SFR_TMR3HLD,
+    SFR_TMR3,
+    SFR_PR2,
+    SFR_PR3,
+    SFR_T3CON,
+    SFR_T4CON,
+    SFR_TMR4,
+    SFR_TMR5HLD,
+    SFR_TMR5,
+    SFR_PR4,
+    SFR_PR5,
+    SFR_T5CON,
+    SFR_IC1BUF,
+    SFR_IC1CON,
+    SFR_IC2BUF,
+    SFR_IC2CON,
+    SFR_IC3BUF,
+    SFR_IC3CON,
+    SFR_IC4BUF,
+    SFR_IC4CON,
+    SFR_IC5BUF,
+    SFR_IC5CON,
+    SFR_IC6BUF,
+    SFR_IC6CON,
+    SFR_IC7BUF,
+    SFR_IC7CON,
+    SFR_IC8BUF,
+    SFR_IC8CON,
+    SFR_PMCON,
+    SFR_PMMODE,
+    SFR_PMADDR,
+    SFR_PMDOUT1,
+    SFR_PMDIN1,
+    SFR_PMAEN,
+    SFR_PMSTAT,
+    SFR_ADC1BUF0,
+    SFR_ADC1BUF1,
+    SFR_ADC1BUF2,
+    SFR_ADC1BUF3,
+    SFR_ADC1BUF4,
+    SFR_ADC1BUF5,
+    SFR_ADC1BUF6,
+    SFR_ADC1BUF7,
+    SFR_ADC1BUF8,
+    SFR_ADC1BUF9,
+    SFR_ADC1BUFA,
+    SFR_ADC1BUFB,
+    SFR_ADC1BUFC,
+    SFR_ADC1BUFD,
+    SFR_ADC1BUFE,
+    SFR_ADC1BUFF,
+    SFR_AD1CON1,
+    SFR_AD1CON2,
+    SFR_AD1CON3,
+    SFR_AD1CHS,
+    SFR_AD1PCFG,
+    SFR_AD1CSSL,
+    SFR_CMCON,
+    SFR_CVRCON,
+    SFR_TRISA,
+    SFR_PORTA,
+    SFR_LATA,
+    SFR_TRISB,
+    SFR_PORTB,
+    SFR_LATB,
+    SFR_TRISC,
+    SFR_PORTC,
+    SFR_LATC,
+    SFR_TRISD,
+    SFR_PORTD,
+    SFR_LATD,
+    SFR_TRISE,
+    SFR_PORTE,
+    SFR_LATE,
+    SFR_TRISF,
+    SFR_PORTF,
+    SFR_LATF,
+    SFR_TRISG,
+    SFR_PORTG,
+    SFR_LATG,
+    SFR_OSCCON,
+    SFR_CLKDIV,
+    SFR_PMD1,
+    SFR_PMD2,
+    SFR_PMD3,
+    SFR_LICZBA
+} sim_sfr_t;
+
+typedef struct {
+    uint16_t C:1;
+    uint16_t Z:1;
+    uint16_t OV:1;
+    uint16_t N:1;
+    uint16_t RA:1;
+    uint16_t IPL:3;
+    uint16_t DC:1;
+    uint16_t :7;
+} SRBITS;
+typedef struct {
+    uint16_t :2;
+    uint16_t PSV:1;
+    uint16_t IPL3:1;
+    uint16_t :12;
+} CORCONBITS;
+typedef struct {
+    uint16_t :15;
+    uint16_t NSTDIS:1;
+} INTCON1BITS;
+typedef struct {
+    uint16_t INT0EP:1;
+    uint16_t INT1EP:1;
+    uint16_t INT2EP:1;
+    uint16_t :11;
+    uint16_t DISI:1;
+    uint16_t ALTIVT:1;
+} INTCON2BITS;
+typedef struct {
+    uint16_t INT0IF:1;
+    uint16_t IC1IF:1;
+    uint16_t OC1IF:1;
+    uint16_t T1IF:1;
+    uint16_t :1;
+    uint16_t IC2IF:1;
+    uint16_t OC2IF:1;
+    uint16_t T2IF:1;
+    uint16_t T3IF:1;
+    uint16_t SPF1IF:1;
+    uint16_t SPI1IF:1;
+    uint16_t U1RXIF:1;
+    uint16_t U1TXIF:1;
+    uint16_t AD1IF:1;
+    uint16_t :2;
+} IFS0BITS;
+typedef struct {
+    uint16_t SI2C1IF:1;
+    uint16_t MI2C1IF:1;
+    uint16_t CMIF:1;
+    uint16_t CNIF:1;
+    uint16_t INT1IF:1;
+    uint16_t :1;
+    uint16_t IC7IF:1;
+    uint16_t IC8IF:1;
+    uint16_t :1;
+    uint16_t OC3IF:1;
+    uint16_t OC4IF:1;
+    uint16_t T4IF:1;
+    uint16_t T5IF:1;
+    uint16_t INT2IF:1;
+    uint16_t U2RXIF:1;
+    uint16_t U2TXIF:1;
+} IFS1BITS;
+typedef struct {
+    uint16_t SPF2IF:1;
+    uint16_t SPI2IF:1;
+    uint16_t :3;
+    uint16_t IC3IF:1;
+    uint16_t IC4IF:1;
+    uint16_t IC5IF:1;
+    uint16_t IC6IF:1;
+    uint16_t OC5IF:1;
+    uint16_t OC6IF:1;
+    uint16_t OC7IF:1;
+    uint16_t OC8IF:1;
+    uint16_t PMPIF:1;
+    uint16_t :2;
+} IFS2BITS;
+typedef struct {
+    uint16_t INT0IE:1;
+    uint16_t IC1IE:1;
+    uint16_t OC1IE:1;
+    uint16_t T1IE:1;
+    uint16_t :1;
+    uint16_t IC2IE:1;
+    uint16_t OC2IE:1;
+    uint16_t T2IE:1;
+    uint16_t T3IE:1;
+    uint16_t SPF1IE:1;
+    uint16_t SPI1IE:1;
+    uint16_t U1RXIE:1;
+    uint16_t U1TXIE:1;
+    uint16_t AD1IE:1;
+    uint16_t :2;
+} IEC0BITS;
+typedef struct {
+    uint16_t SI2C1IE:1;
+    uint16_t MI2C1IE:1;
+    uint16_t CMIE:1;
+    uint16_t CNIE:1;
+    uint16_t INT1IE:1;
+    uint16_t :1;
+    uint16_t IC7IE:1;
+    uint16_t IC8IE:1;
+    uint16_t :1;
+    uint16_t OC3IE:1;
+    uint16_t OC4IE:1;
+    uint16_t T4IE:1;
+    uint16_t T5IE:1;
+    uint16_t INT2IE:1;
+    uint16_t U2RXIE:1;
+    uint16_t U2TXIE:1;
+} IEC1BITS;
+typedef struct {
+    uint16_t SPF2IE:1;
+    uint16_t SPI2IE:1;
+    uint16_t :3;
+    uint16_t IC3IE:1;
+    uint16_t IC4IE:1;
+    uint16_t IC5IE:1;
+    uint16_t IC6IE:1;
+    uint16_t OC5IE:1;
+    uint16_t OC6IE:1;
+    uint16_t OC7IE:1;
+    uint16_t OC8IE:1;
+    uint16_t PMPIE:1;
+    uint16_t :2;
+} IEC2BITS;
+typedef struct {
+    uint16_t INT0IP:3;
+    uint16_t :1;
+    uint16_t IC1IP:3;
+    uint16_t :1;
+    uint16_t OC1IP:3;
+    uint16_t :1;
+    uint16_t T1IP:3;
+    uint16_t :1;
+} IPC0BITS;
+typedef struct {
+    uint16_t :4;
+    uint16_t IC2IP:3;
+    uint16_t :1;
+    uint16_t OC2IP:3;
+    uint16_t :1;
+    uint16_t T2IP:3;
+    uint16_t :1;
+} IPC1BITS;
+typedef struct {
+    uint16_t T3IP:3;
+    uint16_t :1;
+    uint16_t SPF1IP:3;
+    uint16_t :1;
+    uint16_t SPI1IP:3;
+    uint16_t :1;
+    uint16_t U1RXIP:3;
+    uint16_t :1;
+} IPC2BITS;
+typedef struct {
+    uint16_t U1TXIP:3;
+    uint16_t :1;
+    uint16_t AD1IP:3;
+    uint16_t :9;
+} IPC3BITS;
+typedef struct {
+    uint16_t SI2C1IP:3;
+    uint16_t :1;
+    uint16_t MI2C1IP:3;
+    uint16_t :1;
+    uint16_t CMIP:3;
+    uint16_t :1;
+    uint16_t CNIP:3;
+    uint16_t :1;
+} IPC4BITS;
+typedef struct {
+    uint16_t INT1IP:3;
+    uint16_t :5;
+    uint16_t IC7IP:3;
+    uint16_t :1;
+    uint16_t IC8IP:3;
+    uint16_t :1;
+} IPC5BITS;
+typedef struct {
+    uint16_t :4;
+    uint16_t OC3IP:3;
+    uint16_t :1;
+    uint16_t OC4IP:3;
+    uint16_t :1;
+    uint16_t T4IP:3;
+    uint16_t :1;
+} IPC6BITS;
+typedef struct {
+    uint16_t T5IP:3;
+    uint16_t :1;
+    uint16_t INT2IP:3;
+    uint16_t :1;
+    uint16_t U2RXIP:3;
+    uint16_t :1;
+    uint16_t U2TXIP:3;
+    uint16_t :1;
+} IPC7BITS;
+typedef struct {
+    uint16_t SPF2IP:3;
+    uint16_t :1;
+    uint16_t SPI2IP:3;
+    uint16_t :9;
+} IPC8BITS;
+typedef struct {
+    uint16_t :4;
+    uint16_t IC3IP:3;
+    uint16_t :1;
+    uint16_t IC4IP:3;
+    uint16_t :1;
+    uint16_t IC5IP:3;
+    uint16_t :1;
+} IPC9BITS;
+typedef struct {
+    uint16_t IC6IP:3;
+    uint16_t :1;
+    uint16_t OC5IP:3;
+    uint16_t :1;
+    uint16_t OC6IP:3;
+    uint16_t :1;
+    uint16_t OC7IP:3;
+    uint16_t :1;
+} IPC10BITS;
+typedef struct {
+    uint16_t OC8IP:3;
+    uint16_t :1;
+    uint16_t PMPIP:3;
+    uint16_t :9;
+} IPC11BITS;
+typedef struct {
+    uint16_t CN0IE:1;
+    uint16_t CN1IE:1;
+    uint16_t CN2IE:1;
+    uint16_t CN3IE:1;
+    uint16_t CN4IE:1;
+    uint16_t CN5IE:1;
+    uint16_t CN6IE:1;
+    uint16_t CN7IE:1;
+    uint16_t CN8IE:1;
+    uint16_t CN9IE:1;
+    uint16_t CN10IE:1;
+    uint16_t CN11IE:1;
+    uint16_t CN12IE:1;
+    uint16_t CN13IE:1;
+    uint16_t CN14IE:1;
+    uint16_t CN15IE:1;
+} CNEN1BITS;
+typedef struct {
+    uint16_t CN16IE:1;
+    uint16_t CN17IE:1;
+    uint16_t CN18IE:1;
+    uint16_t CN19IE:1;
+    uint16_t CN20IE:1;
+    uint16_t CN21IE:1;
+    uint16_t :10;
+} CNEN2BITS;
+typedef struct {
+    uint16_t CN0PUE:1;
+    uint16_t CN1PUE:1;
+    uint16_t CN2PUE:1;
+    uint16_t CN3PUE:1;
+    uint16_t CN4PUE:1;
+    uint16_t CN5PUE:1;
+    uint16_t CN6PUE:1;
+    uint16_t CN7PUE:1;
+    uint16_t CN8PUE:1;
+    uint16_t CN9PUE:1;
+    uint16_t CN10PUE:1;
+    uint16_t CN11PUE:1;
+    uint16_t CN12PUE:1;
+    uint16_t CN13PUE:1;
+    uint16_t CN14PUE:1;
+    uint16_t CN15PUE:1;
+} CNPU1BITS;
+typedef struct {
+    uint16_t CN16PUE:1;
+    uint16_t CN17PUE:1;
+    uint16_t CN18PUE:1;
+    uint16_t CN19PUE:1;
+    uint16_t CN20PUE:1;
+    uint16_t CN21PUE:1;
+    uint16_t :10;
+} CNPU2BITS;
+typedef struct {
+    uint16_t :1;
+    uint16_t TCS:1;
+    uint16_t TSYNC:1;
+    uint16_t :1;
+    uint16_t TCKPS:2;
+    uint16_t TGATE:1;
+    uint16_t :6;
+    uint16_t TSIDL:1;
+    uint16_t :1;
+    uint16_t TON:1;
+} T1CONBITS;
+typedef struct {
+    uint16_t :1;
+    uint16_t TCS:1;
+    uint16_t :1;
+    uint16_t T32:1;
+    uint16_t TCKPS:2;
+    uint16_t TGATE:1;
+    uint16_t :6;
+    uint16_t TSIDL:1;
+    uint16_t :1;
+    uint16_t TON:1;
+} T2CONBITS;
+typedef struct {
+    uint16_t :1;
+    uint16_t TCS:1;
+    uint16_t :2;
+    uint16_t TCKPS:2;
+    uint16_t TGATE:1;
+    uint16_t :6;
+    uint16_t TSIDL:1;
+    uint16_t :1;
+    uint16_t TON:1;
+} T3CONBITS;
+typedef struct {
+    uint16_t :1;
+    uint16_t TCS:1;
+    uint16_t :1;
+    uint16_t T32:1;
+    uint16_t TCKPS:2;
+    uint16_t TGATE:1;
+    uint16_t :6;
+    uint16_t TSIDL:1;
+    uint16_t :1;
+    uint16_t TON:1;
+} T4CONBITS;
+typedef struct {
+    uint16_t :1;
+    uint16_t TCS:1;
+    uint16_t :2;
+    uint16_t TCKPS:2;
+    uint16_t TGATE:1;
+    uint16_t :6;
+    uint16_t TSIDL:1;
+    uint16_t :1;
+    uint16_t TON:1;
+} T5CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC1CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC2CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC3CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC4CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC5CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC6CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC7CONBITS;
+typedef struct {
+    uint16_t ICM:3;
+    uint16_t ICBNE:1;
+    uint16_t ICOV:1;
+    uint16_t ICI:2;
+    uint16_t ICTMR:1;
+    uint16_t :5;
+    uint16_t ICSIDL:1;
+    uint16_t :2;
+} IC8CONBITS;
+typedef struct {
+    uint16_t RDSP:1;
+    uint16_t WRSP:1;
+    uint16_t BEP:1;
+    uint16_t CS1P:1;
+    uint16_t CS2P:1;
+    uint16_t ALP:1;
+    uint16_t CSF:2;
+    uint16_t PTRDEN:1;
+    uint16_t PTWREN:1;
+    uint16_t PTBEEN:1;
+    uint16_t ADRMUX:2;
+    uint16_t PSIDL:1;
+    uint16_t :1;
+    uint16_t PMPEN:1;
+} PMCONBITS;
+typedef struct {
+    uint16_t WAITE:2;
+    uint16_t WAITM:4;
+    uint16_t WAITB:2;
+    uint16_t MODE:2;
+    uint16_t MODE16:1;
+    uint16_t INCM:2;
+    uint16_t IRQM:2;
+    uint16_t BUSY:1;
+} PMMODEBITS;
+typedef struct {
+    uint16_t PTEN0:1;
+    uint16_t PTEN1:1;
+    uint16_t PTEN2:1;
+    uint16_t PTEN3:1;
+    uint16_t PTEN4:1;
+    uint16_t PTEN5:1;
+    uint16_t PTEN6:1;
+    uint16_t PTEN7:1;
+    uint16_t PTEN8:1;
+    uint16_t PTEN9:1;
+    uint16_t PTEN10:1;
+    uint16_t PTEN11:1;
+    uint16_t PTEN12:1;
+    uint16_t PTEN13:1;
+    uint16_t PTEN14:1;
+    uint16_t PTEN15:1;
+} PMAENBITS;
+typedef struct {
+    uint16_t OB0E:1;
+    uint16_t :5;
+    uint16_t OBUF:1;
+    uint16_t OBE:1;
+    uint16_t IB0F:1;
+    uint16_t :5;
+    uint16_t IBOV:1;
+    uint16_t IBF:1;
+} PMSTATBITS;
+typedef struct {
+    uint16_t DONE:1;
+    uint16_t SAMP:1;
+    uint16_t ASAM:1;
+    uint16_t :2;
+    uint16_t SSRC:3;
+    uint16_t FORM:2;
+    uint16_t :3;
+    uint16_t ADSIDL:1;
+    uint16_t :1;
+    uint16_t ADON:1;
+} AD1CON1BITS;
+typedef struct {
+    uint16_t ALTS:1;
+    uint16_t BUFM:1;
+    uint16_t SMPI:4;
+    uint16_t :1;
+    uint16_t BUFS:1;
+    uint16_t :2;
+    uint16_t CSCNA:1;
+    uint16_t :2;
+    uint16_t VCFG:3;
+} AD1CON2BITS;
+typedef struct {
+    uint16_t ADCS:8;
+    uint16_t SAMC:5;
+    uint16_t :2;
+    uint16_t ADRC:1;
+} AD1CON3BITS;
+typedef struct {
+    uint16_t CH0SA:4;
+    uint16_t :3;
+    uint16_t CH0NA:1;
+    uint16_t CH0SB:4;
+    uint16_t :3;
+    uint16_t CH0NB:1;
+} AD1CHSBITS;
+typedef struct {
+    uint16_t PCFG0:1;
+    uint16_t PCFG1:1;
+    uint16_t PCFG2:1;
+    uint16_t PCFG3:1;
+    uint16_t PCFG4:1;
+    uint16_t PCFG5:1;
+    uint16_t PCFG6:1;
+    uint16_t PCFG7:1;
+    uint16_t PCFG8:1;
+    uint16_t PCFG9:1;
+    uint16_t PCFG10:1;
+    uint16_t PCFG11:1;
+    uint16_t PCFG12:1;
+    uint16_t PCFG13:1;
+    uint16_t PCFG14:1;
+    uint16_t PCFG15:1;
+} AD1PCFGBITS;
+typedef struct {
+    uint16_t CSSL0:1;
+    uint16_t CSSL1:1;
+    uint16_t CSSL2:1;
+    uint16_t CSSL3:1;
+    uint16_t CSSL4:1;
+    uint16_t CSSL5:1;
+    uint16_t CSSL6:1;
+    uint16_t CSSL7:1;
+    uint16_t CSSL8:1;
+    uint16_t CSSL9:1;
+    uint16_t CSSL10:1;
+    uint16_t CSSL11:1;
+    uint16_t CSSL12:1;
+    uint16_t CSSL13:1;
+    uint16_t CSSL14:1;
+    uint16_t CSSL15:1;
+} AD1CSSLBITS;
+typedef struct {
+    uint16_t C1POS:1;
+    uint16_t C1NEG:1;
+    uint16_t C2POS:1;
+    uint16_t C2NEG:1;
+    uint16_t C1INV:1;
+    uint16_t C2INV:1;
+    uint16_t C1OUT:1;
+    uint16_t C2OUT:1;
+    uint16_t C1OUTEN:1;
+    uint16_t C2OUTEN:1;
+    uint16_t C1EN:1;
+    uint16_t C2EN:1;
+    uint16_t C1EVT:1;
+    uint16_t C2EVT:1;
+    uint16_t :1;
+    uint16_t CMIDL:1;
+} CMCONBITS;
+typedef struct {
+    uint16_t CVR:4;
+    uint16_t CVRSS:1;
+    uint16_t CVRR:1;
+    uint16_t CVROE:1;
+    uint16_t CVREN:1;
+    uint16_t :8;
+} CVRCONBITS;
+typedef struct {
+    uint16_t TRISA0:1;
+    uint16_t TRISA1:1;
+    uint16_t TRISA2:1;
+    uint16_t TRISA3:1;
+    uint16_t TRISA4:1;
+    uint16_t TRISA5:1;
+    uint16_t TRISA6:1;
+    uint16_t TRISA7:1;
+    uint16_t TRISA8:1;
+    uint16_t TRISA9:1;
+    uint16_t TRISA10:1;
+    uint16_t TRISA11:1;
+    uint16_t TRISA12:1;
+    uint16_t TRISA13:1;
+    uint16_t TRISA14:1;
+    uint16_t TRISA15:1;
+} TRISABITS;
+typedef struct {
+    uint16_t RA0:1;
+    uint16_t RA1:1;
+    uint16_t RA2:1;
+    uint16_t RA3:1;
+    uint16_t RA4:1;
+    uint16_t RA5:1;
+    uint16_t RA6:1;
+    uint16_t RA7:1;
+    uint16_t RA8:1;
+    uint16_t RA9:1;
+    uint16_t RA10:1;
+    uint16_t RA11:1;
+    uint16_t RA12:1;
+    uint16_t RA13:1;
+    uint16_t RA14:1;
+    uint16_t RA15:1;
+} PORTABITS;
+typedef struct {
+    uint16_t LATA0:1;
+    uint16_t LATA1:1;
+    uint16_t LATA2:1;
+    uint16_t LATA3:1;
+    uint16_t LATA4:1;
+    uint16_t LATA5:1;
+    uint16_t LATA6:1;
+    uint16_t LATA7:1;
+    uint16_t LATA8:1;
+    uint16_t LATA9:1;
+    uint16_t LATA10:1;
+    uint16_t LATA11:1;
+    uint16_t LATA12:1;
+    uint16_t LATA13:1;
+    uint16_t LATA14:1;
+    uint16_t LATA15:1;
+} LATABITS;
+typedef struct {
+    uint16_t TRISB0:1;
+    uint16_t TRISB1:1;
+    uint16_t TRISB2:1;
+    uint16_t TRISB3:1;
+    uint16_t TRISB4:1;
+    uint16_t TRISB5:1;
+    uint16_t TRISB6:1;
+    uint16_t TRISB7:1;
+    uint16_t TRISB8:1;
+    uint16_t TRISB9:1;
+    uint16_t TRISB10:1;
+    uint16_t TRISB11:1;
+    uint16_t TRISB12:1;
+    uint16_t TRISB13:1;
+    uint16_t TRISB14:1;
+    uint16_t TRISB15:1;
+} TRISBBITS;
+typedef struct {
+    uint16_t RB0:1;
+    uint16_t RB1:1;
+    uint16_t RB2:1;
+    uint16_t RB3:1;
+    uint16_t RB4:1;
+    uint16_t RB5:1;
+    uint16_t RB6:1;
+    uint16_t RB7:1;
+    uint16_t RB8:1;
+    uint16_t RB9:1;
+    uint16_t RB10:1;
+    uint16_t RB11:1;
+    uint16_t RB12:1;
+    uint16_t RB13:1;
+    uint16_t RB14:1;
+    uint16_t RB15:1;
+} PORTBBITS;
+typedef struct {
+    uint16_t LATB0:1;
+    uint16_t LATB1:1;
+    uint16_t LATB2:1;
+    uint16_t LATB3:1;
+    uint16_t LATB4:1;
+    uint16_t LATB5:1;
+    uint16_t LATB6:1;
+    uint16_t LATB7:1;
+    uint16_t LATB8:1;
+    uint16_t LATB9:1;
+    uint16_t LATB10:1;
+    uint16_t LATB11:1;
+    uint16_t LATB12:1;
+    uint16_t LATB13:1;
+    uint16_t LATB14:1;
+    uint16_t LATB15:1;
+} LATBBITS;
+typedef struct {
+    uint16_t TRISC0:1;
+    uint16_t TRISC1:1;
+    uint16_t TRISC2:1;
+    uint16_t TRISC3:1;
+    uint16_t TRISC4:1;
+    uint16_t TRISC5:1;
+    uint16_t TRISC6:1;
+    uint16_t TRISC7:1;
+    uint16_t TRISC8:1;
+    uint16_t TRISC9:1;
+    uint16_t TRISC10:1;
+    uint16_t TRISC11:1;
+    uint16_t TRISC12:1;
+    uint16_t TRISC13:1;
+    uint16_t TRISC14:1;
+    uint16_t TRISC15:1;
+} TRISCBITS;
+typedef struct {
+    uint16_t RC0:1;
+    uint16_t RC1:1;
+    uint16_t RC2:1;
+    uint16_t RC3:1;
+    uint16_t RC4:1;
+    uint16_t RC5:1;
+    uint16_t RC6:1;
+    uint16_t RC7:1;
+    uint16_t RC8:1;
+    uint16_t RC9:1;
+    uint16_t RC10:1;
+    uint16_t RC11:1;
+    uint16_t RC12:1;
+    uint16_t RC13:1;
+    uint16_t RC14:1;
+    uint16_t RC15:1;
+} PORTCBITS;
+typedef struct {
+    uint16_t LATC0:1;
+    uint16_t LATC1:1;
+    uint16_t LATC2:1;
+    uint16_t LATC3:1;
+    uint16_t LATC4:1;
+    uint16_t LATC5:1;
+    uint16_t LATC6:1;
+    uint16_t LATC7:1;
+    uint16_t LATC8:1;
+    uint16_t LATC9:1;
+    uint16_t LATC10:1;
+    uint16_t LATC11:1;
+    uint16_t LATC12:1;
+    uint16_t LATC13:1;
+    uint16_t LATC14:1;
+    uint16_t LATC15:1;
+} LATCBITS;
+typedef struct {
+    uint16_t TRISD0:1;
+    uint16_t TRISD1:1;
+    uint16_t TRISD2:1;
+    uint16_t TRISD3:1;
+    uint16_t TRISD4:1;
+    uint16_t TRISD5:1;
+    uint16_t TRISD6:1;
+    uint16_t TRISD7:1;
+    uint16_t TRISD8:1;
+    uint16_t TRISD9:1;
+    uint16_t TRISD10:1;
+    uint16_t TRISD11:1;
+    uint16_t TRISD12:1;
+    uint16_t TRISD13:1;
+    uint16_t TRISD14:1;
+    uint16_t TRISD15:1;
+} TRISDBITS;
+typedef struct {
+    uint16_t RD0:1;
+    uint16_t RD1:1;
+    uint16_t RD2:1;
+    uint16_t RD3:1;
+    uint16_t RD4:1;
+    uint16_t RD5:1;
+    uint16_t RD6:1;
+    uint16_t RD7:1;
+    uint16_t RD8:1;
+    uint16_t RD9:1;
+    uint16_t RD10:1;
+    uint16_t RD11:1;
+    uint16_t RD12:1;
+    uint16_t RD13:1;
+    uint16_t RD14:1;
+    uint16_t RD15:1;
+} PORTDBITS;
+typedef struct {
+    uint16_t LATD0:1;
+    uint16_t LATD1:1;
+    uint16_t LATD2:1;
+    uint16_t LATD3:1;
+    uint16_t LATD4:1;
+    uint16_t LATD5:1;
+    uint16_t LATD6:1;
+    uint16_t LATD7:1;
+    uint16_t LATD8:1;
+    uint16_t LATD9:1;
+    uint16_t LATD10:1;
+    uint16_t LATD11:1;
+    uint16_t LATD12:1;
+    uint16_t LATD13:1;
+    uint16_t LATD14:1;
+    uint16_t LATD15:1;
+} LATDBITS;
+typedef struct {
+    uint16_t TRISE0:1;
+    uint16_t TRISE1:1;
+    uint16_t TRISE2:1;
+    uint16_t TRISE3:1;
+    uint16_t TRISE4:1;
+    uint16_t TRISE5:1;
+    uint16_t TRISE6:1;
+    uint16_t TRISE7:1;
+    uint16_t TRISE8:1;
+    uint16_t TRISE9:1;
+    uint16_t TRISE10:1;
+    uint16_t TRISE11:1;
+    uint16_t TRISE12:1;
+    uint16_t TRISE13:1;
+    uint16_t TRISE14:1;
+    uint16_t TRISE15:1;
+} TRISEBITS;
+typedef struct {
+    uint16_t RE0:1;
+    uint16_t RE1:1;
+    uint16_t RE2:1;
+    uint16_t RE3:1;
+    uint16_t RE4:1;
+    uint16_t RE5:1;
+    uint16_t RE6:1;
+    uint16_t RE7:1;
+    uint16_t RE8:1;
+    uint16_t RE9:1;
+    uint16_t RE10:1;
+    uint16_t RE11:1;
+    uint16_t RE12:1;
+    uint16_t RE13:1;
+    uint16_t RE14:1;
+    uint16_t RE15:1;
+} PORTEBITS;
+typedef struct {
+    uint16_t LATE0:1;
+    uint16_t LATE1:1;
+    uint16_t LATE2:1;
+    uint16_t LATE3:1;
+    uint16_t LATE4:1;
+    uint16_t LATE5:1;
+    uint16_t LATE6:1;
+    uint16_t LATE7:1;
+    uint16_t LATE8:1;
+    uint16_t LATE9:1;
+    uint16_t LATE10:1;
+    uint16_t LATE11:1;
+    uint16_t LATE12:1;
+    uint16_t LATE13:1;
+    uint16_t LATE14:1;
+    uint16_t LATE15:1;
+} LATEBITS;
+typedef struct {
+    uint16_t TRISF0:1;
+    uint16_t TRISF1:1;
+    uint16_t TRISF2:1;
+    uint16_t TRISF3:1;
+    uint16_t TRISF4:1;
+    uint16_t TRISF5:1;
+    uint16_t TRISF6:1;
+    uint16_t TRISF7:1;
+    uint16_t TRISF8:1;
+    uint16_t TRISF9:1;
+    uint16_t TRISF10:1;
+    uint16_t TRISF11:1;
+    uint16_t TRISF12:1;
+    uint16_t TRISF13:1;
+    uint16_t TRISF14:1;
+    uint16_t TRISF15:1;
+} TRISFBITS;
+typedef struct {
+    uint16_t RF0:1;
+    uint16_t RF1:1;
+    uint16_t RF2:1;
+    uint16_t RF3:1;
+    uint16_t RF4:1;
+    uint16_t RF5:1;
+    uint16_t RF6:1;
+    uint16_t RF7:1;
+    uint16_t RF8:1;
+    uint16_t RF9:1;
+    uint16_t RF10:1;
+    uint16_t RF11:1;
+    uint16_t RF12:1;
+    uint16_t RF13:1;
+    uint16_t RF14:1;
+    uint16_t RF15:1;
+} PORTFBITS;
+typedef struct {
+    uint16_t LATF0:1;
+    uint16_t LATF1:1;
+    uint16_t LATF2:1;
+    uint16_t LATF3:1;
+    uint16_t LATF4:1;
+    uint16_t LATF5:1;
+    uint16_t LATF6:1;
+    uint16_t LATF7:1;
+    uint16_t LATF8:1;
+    uint16_t LATF9:1;
+    uint16_t LATF10:1;
+    uint16_t LATF11:1;
+    uint16_t LATF12:1;
+    uint16_t LATF13:1;
+    uint16_t LATF14:1;
+    uint16_t LATF15:1;
+} LATFBITS;
+typedef struct {
+    uint16_t TRISG0:1;
+    uint16_t TRISG1:1;
+    uint16_t TRISG2:1;
+    uint16_t TRISG3:1;
+    uint16_t TRISG4:1;
+    uint16_t TRISG5:1;
+    uint16_t TRISG6:1;
+    uint16_t TRISG7:1;
+    uint16_t TRISG8:1;
+    uint16_t TRISG9:1;
+    uint16_t TRISG10:1;
+    uint16_t TRISG11:1;
+    uint16_t TRISG12:1;
+    uint16_t TRISG13:1;
+    uint16_t TRISG14:1;
+    uint16_t TRISG15:1;
+} TRISGBITS;
+typedef struct {
+    uint16_t RG0:1;
+    uint16_t RG1:1;
+    uint16_t RG2:1;
+    uint16_t RG3:1;
+    uint16_t RG4:1;
+    uint16_t RG5:1;
+    uint16_t RG6:1;
+    uint16_t RG7:1;
+    uint16_t RG8:1;
+    uint16_t RG9:1;
+    uint16_t RG10:1;
+    uint16_t RG11:1;
+    uint16_t RG12:1;
+    uint16_t RG13:1;
+    uint16_t RG14:1;
+    uint16_t RG15:1;
+} PORTGBITS;
+typedef struct {
+    uint16_t LATG0:1;
+    uint16_t LATG1:1;
+    uint16_t LATG2:1;
+    uint16_t LATG3:1;
+    uint16_t LATG4:1;
+    uint16_t LATG5:1;
+    uint16_t LATG6:1;
+    uint16_t LATG7:1;
+    uint16_t LATG8:1;
+    uint16_t LATG9:1;
+    uint16_t LATG10:1;
+    uint16_t LATG11:1;
+    uint16_t LATG12:1;
+    uint16_t LATG13:1;
+    uint16_t LATG14:1;
+    uint16_t LATG15:1;
+} LATGBITS;
+typedef struct {
+    uint16_t OSWEN:1;
+    uint16_t SOSCEN:1;
+    uint16_t :1;
+    uint16_t CF:1;
+    uint16_t :1;
+    uint16_t LOCK:1;
+    uint16_t :1;
+    uint16_t CLKLOCK:1;
+    uint16_t NOSC:3;
+    uint16_t :1;
+    uint16_t COSC:3;
+    uint16_t :1;
+} OSCCONBITS;
+typedef struct {
+    uint16_t :8;
+    uint16_t RCDIV:3;
+    uint16_t DOZEN:1;
+    uint16_t DOZE:3;
+    uint16_t ROI:1;
+} CLKDIVBITS;
+typedef struct {
+    uint16_t ADC1MD:1;
+    uint16_t :2;
+    uint16_t SPI1MD:1;
+    uint16_t SPI2MD:1;
+    uint16_t U1MD:1;
+    uint16_t U2MD:1;
+    uint16_t I2C1MD:1;
+    uint16_t :3;
+    uint16_t T1MD:1;
+    uint16_t T2MD:1;
+    uint16_t T3MD:1;
+    uint16_t T4MD:1;
+    uint16_t T5MD:1;
+} PMD1BITS;
+typedef struct {
+    uint16_t IC1MD:1;
+    uint16_t IC2MD:1;
+    uint16_t IC3MD:1;
+    uint16_t IC4MD:1;
+    uint16_t IC5MD:1;
+    uint16_t IC6MD:1;
+    uint16_t IC7MD:1;
+    uint16_t IC8MD:1;
+    uint16_t OC1MD:1;
+    uint16_t OC2MD:1;
+    uint16_t OC3MD:1;
+    uint16_t OC4MD:1;
+    uint16_t OC5MD:1;
+    uint16_t OC6MD:1;
+    uint16_t OC7MD:1;
+    uint16_t OC8MD:1;
+} PMD2BITS;
+typedef struct {
+    uint16_t :1;
+    uint16_t I2C2MD:1;
+    uint16_t :5;
+    uint16_t CRCPMD:1;
+    uint16_t PMPMD:1;
+    uint16_t RTCCMD:1;
+    uint16_t CMPMD:1;
+    uint16_t :5;
+} PMD3BITS;
+
+#define SR         (*sim_sfr(SFR_SR))
+#define SRbits     (*(volatile SRBITS *)sim_sfr(SFR_SR))
+#define CORCON     (*sim_sfr(SFR_CORCON))
+#define CORCONbits (*(volatile CORCONBITS *)sim_sfr(SFR_CORCON))
+#define INTCON1    (*sim_sfr(SFR_INTCON1))
+#define INTCON1bits (*(volatile INTCON1BITS *)sim_sfr(SFR_INTCON1))
+#define INTCON2    (*sim_sfr(SFR_INTCON2))
+#define INTCON2bits (*(volatile INTCON2BITS *)sim_sfr(SFR_INTCON2))
+#define IFS0       (*sim_sfr(SFR_IFS0))
+#define IFS0bits   (*(volatile IFS0BITS *)sim_sfr(SFR_IFS0))
+#define IFS1       (*sim_sfr(SFR_IFS1))
+#define IFS1bits   (*(volatile IFS1BITS *)sim_sfr(SFR_IFS1))
+#define IFS2       (*sim_sfr(SFR_IFS2))
+#define IFS2bits   (*(volatile IFS2BITS *)sim_sfr(SFR_IFS2))
+#define IEC0       (*sim_sfr(SFR_IEC0))
+#define IEC0bits   (*(volatile IEC0BITS *)sim_sfr(SFR_IEC0))
+#define IEC1       (*sim_sfr(SFR_IEC1))
+#define IEC1bits   (*(volatile IEC1BITS *)sim_sfr(SFR_IEC1))
+#define IEC2       (*sim_sfr(SFR_IEC2))
+#define IEC2bits   (*(volatile IEC2BITS *)sim_sfr(SFR_IEC2))
+#define IPC0       (*sim_sfr(SFR_IPC0))
+#define IPC0bits   (*(volatile IPC0BITS *)sim_sfr(SFR_IPC0))
+#define IPC1       (*sim_sfr(SFR_IPC1))
+#define IPC1bits   (*(volatile IPC1BITS *)sim_sfr(SFR_IPC1))
+#define IPC2       (*sim_sfr(SFR_IPC2))
+#define IPC2bits   (*(volatile IPC2BITS *)sim_sfr(SFR_IPC2))
+#define IPC3       (*sim_sfr(SFR_IPC3))
+#define IPC3bits   (*(volatile IPC3BITS *)sim_sfr(SFR_IPC3))
+#define IPC4       (*sim_sfr(SFR_IPC4))
+#define IPC4bits   (*(volatile IPC4BITS *)sim_sfr(SFR_IPC4))
+#define IPC5       (*sim_sfr(SFR_IPC5))
+#define IPC5bits   (*(volatile IPC5BITS *)sim_sfr(SFR_IPC5))
+#define IPC6       (*sim_sfr(SFR_IPC6))
+#define IPC6bits   (*(volatile IPC6BITS *)sim_sfr(SFR_IPC6))
+#define IPC7       (*sim_sfr(SFR_IPC7))
+#define IPC7bits   (*(volatile IPC7BITS *)sim_sfr(SFR_IPC7))
+#define IPC8       (*sim_sfr(SFR_IPC8))
+#define IPC8bits   (*(volatile IPC8BITS *)sim_sfr(SFR_IPC8))
+#define IPC9       (*sim_sfr(SFR_IPC9))
+#define IPC9bits   (*(volatile IPC9BITS *)sim_sfr(SFR_IPC9))
+#define IPC10      (*sim_sfr(SFR_IPC10))
+#define IPC10bits  (*(volatile IPC10BITS *)sim_sfr(SFR_IPC10))
+#define IPC11      (*sim_sfr(SFR_IPC11))
+#define IPC11bits  (*(volatile IPC11BITS *)sim_sfr(SFR_IPC11))
+#define CNEN1      (*sim_sfr(SFR_CNEN1))
+#define CNEN1bits  (*(volatile CNEN1BITS *)sim_sfr(SFR_CNEN1))
+#define CNEN2      (*sim_sfr(SFR_CNEN2))
+#define CNEN2bits  (*(volatile CNEN2BITS *)sim_sfr(SFR_CNEN2))
+#define CNPU1      (*sim_sfr(SFR_CNPU1))
+#define CNPU1bits  (*(volatile CNPU1BITS *)sim_sfr(SFR_CNPU1))
+#define CNPU2      (*sim_sfr(SFR_CNPU2))
+#define CNPU2bits  (*(volatile CNPU2BITS *)sim_sfr(SFR_CNPU2))
+#define T1CON      (*sim_sfr(SFR_T1CON))
+#define T1CONbits  (*(volatile T1CONBITS *)sim_sfr(SFR_T1CON))
+#define TMR1       (*sim_sfr(SFR_TMR1))
+#define PR1        (*sim_sfr(SFR_PR1))
+#define T2CON      (*sim_sfr(SFR_T2CON))
+#define T2CONbits  (*(volatile T2CONBITS *)sim_sfr(SFR_T2CON))
+#define TMR2       (*sim_sfr(SFR_TMR2))
+#define TMR3HLD    (*sim_sfr(SFR_TMR3HLD))
+#define TMR3       (*sim_sfr(SFR_TMR3))
+#define PR2        (*sim_sfr(SFR_PR2))
+#define PR3        (*sim_sfr(SFR_PR3))
+#define T3CON      (*sim_sfr(SFR_T3CON))
+#define T3CONbits  (*(volatile T3CONBITS *)sim_sfr(SFR_T3CON))
+#define T4CON      (*sim_sfr(SFR_T4CON))
+#define T4CONbits  (*(volatile T4CONBITS *)sim_sfr(SFR_T4CON))
+#define TMR4       (*sim_sfr(SFR_TMR4))
+#define TMR5HLD    (*sim_sfr(SFR_TMR5HLD))
+#define TMR5       (*sim_sfr(SFR_TMR5))
+#define PR4        (*sim_sfr(SFR_PR4))
+#define PR5        (*sim_sfr(SFR_PR5))
+#define T5CON      (*sim_sfr(SFR_T5CON))
+#define T5CONbits  (*(volatile T5CONBITS *)sim_sfr(SFR_T5CON))
+#define IC1BUF     (*sim_sfr(SFR_IC1BUF))
+#define IC1CON     (*sim_sfr(SFR_IC1CON))
+#define IC1CONbits (*(volatile IC1CONBITS *)sim_sfr(SFR_IC1CON))
+#define IC2BUF     (*sim_sfr(SFR_IC2BUF))
+#define IC2CON     (*sim_sfr(SFR_IC2CON))
+#define IC2CONbits (*(volatile IC2CONBITS *)sim_sfr(SFR_IC2CON))
+#define IC3BUF     (*sim_sfr(SFR_IC3BUF))
+#define IC3CON     (*sim_sfr(SFR_IC3CON))
+#define IC3CONbits (*(volatile IC3CONBITS *)sim_sfr(SFR_IC3CON))
+#define IC4BUF     (*sim_sfr(SFR_IC4BUF))
+#define IC4CON     (*sim_sfr(SFR_IC4CON))
+#define IC4CONbits (*(volatile IC4CONBITS *)sim_sfr(SFR_IC4CON))
+#define IC5BUF     (*sim_sfr(SFR_IC5BUF))
+#define IC5CON     (*sim_sfr(SFR_IC5CON))
+#define IC5CONbits (*(volatile IC5CONBITS *)sim_sfr(SFR_IC5CON))
+#define IC6BUF     (*sim_sfr(SFR_IC6BUF))
+#define IC6CON     (*sim_sfr(SFR_IC6CON))
+#define IC6CONbits (*(volatile IC6CONBITS *)sim_sfr(SFR_IC6CON))
+#define IC7BUF     (*sim_sfr(SFR_IC7BUF))
+#define IC7CON     (*sim_sfr(SFR_IC7CON))
+#define IC7CONbits (*(volatile IC7CONBITS *)sim_sfr(SFR_IC7CON))
+#define IC8BUF     (*sim_sfr(SFR_IC8BUF))
+#define IC8CON     (*sim_sfr(SFR_IC8CON))
+#define IC8CONbits (*(volatile IC8CONBITS *)sim_sfr(SFR_IC8CON))
+#define PMCON      (*sim_sfr(SFR_PMCON))
+#define PMCONbits  (*(volatile PMCONBITS *)sim_sfr(SFR_PMCON))
+#define PMMODE     (*sim_sfr(SFR_PMMODE))
+#define PMMODEbits (*(volatile PMMODEBITS *)sim_sfr(SFR_PMMODE))
+#define PMADDR     (*sim_sfr(SFR_PMADDR))
+#define PMDOUT1    (*sim_sfr(SFR_PMDOUT1))
+#define PMDIN1     (*sim_sfr(SFR_PMDIN1))
+#define PMAEN      (*sim_sfr(SFR_PMAEN))
+#define PMAENbits  (*(volatile PMAENBITS *)sim_sfr(SFR_PMAEN))
+#define PMSTAT     (*sim_sfr(SFR_PMSTAT))
+#define PMSTATbits (*(volatile PMSTATBITS *)sim_sfr(SFR_PMSTAT))
+#define ADC1BUF0   (*sim_sfr(SFR_ADC1BUF0))
+#define ADC1BUF1   (*sim_sfr(SFR_ADC1BUF1))
+#define ADC1BUF2   (*sim_sfr(SFR_ADC1BUF2))
+#define ADC1BUF3   (*sim_sfr(SFR_ADC1BUF3))
+#define ADC1BUF4   (*sim_sfr(SFR_ADC1BUF4))
+#define ADC1BUF5   (*sim_sfr(SFR_ADC1BUF5))
+#define ADC1BUF6   (*sim_sfr(SFR_ADC1BUF6))
+#define ADC1BUF7   (*sim_sfr(SFR_ADC1BUF7))
+#define ADC1BUF8   (*sim_sfr(SFR_ADC1BUF8))
+#define ADC1BUF9   (*sim_sfr(SFR_ADC1BUF9))
+#define ADC1BUFA   (*sim_sfr(SFR_ADC1BUFA))
+#define ADC1BUFB   (*sim_sfr(SFR_ADC1BUFB))
+#define ADC1BUFC   (*sim_sfr(SFR_ADC1BUFC))
+#define ADC1BUFD   (*sim_sfr(SFR_ADC1BUFD))
+#define ADC1BUFE   (*sim_sfr(SFR_ADC1BUFE))
+#define ADC1BUFF   (*sim_sfr(SFR_ADC1BUFF))
+#define AD1CON1    (*sim_sfr(SFR_AD1CON1))
+#define AD1CON1bits (*(volatile AD1CON1BITS *)sim_sfr(SFR_AD1CON1))
+#define AD1CON2    (*sim_sfr(SFR_AD1CON2))
+#define AD1CON2bits (*(volatile AD1CON2BITS *)sim_sfr(SFR_AD1CON2))
+#define AD1CON3    (*sim_sfr(SFR_AD1CON3))
+#define AD1CON3bits (*(volatile AD1CON3BITS *)sim_sfr(SFR_AD1CON3))
+#define AD1CHS     (*sim_sfr(SFR_AD1CHS))
+#define AD1CHSbits (*(volatile AD1CHSBITS *)sim_sfr(SFR_AD1CHS))
+#define AD1PCFG    (*sim_sfr(SFR_AD1PCFG))
+#define AD1PCFGbits (*(volatile AD1PCFGBITS *)sim_sfr(SFR_AD1PCFG))
+#define AD1CSSL    (*sim_sfr(SFR_AD1CSSL))
+#define AD1CSSLbits (*(volatile AD1CSSLBITS *)sim_sfr(SFR_AD1CSSL))
+#define CMCON      (*sim_sfr(SFR_CMCON))
+#define CMCONbits  (*(volatile CMCONBITS *)sim_sfr(SFR_CMCON))
+#define CVRCON     (*sim_sfr(SFR_CVRCON))
+#define CVRCONbits (*(volatile CVRCONBITS *)sim_sfr(SFR_CVRCON))
+#define TRISA      (*sim_sfr(SFR_TRISA))
+#define TRISAbits  (*(volatile TRISABITS *)sim_sfr(SFR_TRISA))
+#define PORTA      (*sim_sfr(SFR_PORTA))
+#define PORTAbits  (*(volatile PORTABITS *)sim_sfr(SFR_PORTA))
+#define LATA       (*sim_sfr(SFR_LATA))
+#define LATAbits   (*(volatile LATABITS *)sim_sfr(SFR_LATA))
+#define TRISB      (*sim_sfr(SFR_TRISB))
+#define TRISBbits  (*(volatile TRISBBITS *)sim_sfr(SFR_TRISB))
+#define PORTB      (*sim_sfr(SFR_PORTB))
+#define PORTBbits  (*(volatile PORTBBITS *)sim_sfr(SFR_PORTB))
+#define LATB       (*sim_sfr(SFR_LATB))
+#define LATBbits   (*(volatile LATBBITS *)sim_sfr(SFR_LATB))
+#define TRISC      (*sim_sfr(SFR_TRISC))
+#define TRISCbits  (*(volatile TRISCBITS *)sim_sfr(SFR_TRISC))
+#define PORTC      (*sim_sfr(SFR_PORTC))
+#define PORTCbits  (*(volatile PORTCBITS *)sim_sfr(SFR_PORTC))
+#define LATC       (*sim_sfr(SFR_LATC))
+#define LATCbits   (*(volatile LATCBITS *)sim_sfr(SFR_LATC))
+#define TRISD      (*sim_sfr(SFR_TRISD))
+#define TRISDbits  (*(volatile TRISDBITS *)sim_sfr(SFR_TRISD))
+#define PORTD      (*sim_sfr(SFR_PORTD))
+#define PORTDbits  (*(volatile PORTDBITS *)sim_sfr(SFR_PORTD))
+#define LATD       (*sim_sfr(SFR_LATD))
+#define LATDbits   (*(volatile LATDBITS *)sim_sfr(SFR_LATD))
+#define TRISE      (*sim_sfr(SFR_TRISE))
+#define TRISEbits  (*(volatile TRISEBITS *)sim_sfr(SFR_TRISE))
+#define PORTE      (*sim_sfr(SFR_PORTE))
+#define PORTEbits  (*(volatile PORTEBITS *)sim_sfr(SFR_PORTE))
+#define LATE       (*sim_sfr(SFR_LATE))
+#define LATEbits   (*(volatile LATEBITS *)sim_sfr(SFR_LATE))
+#define TRISF      (*sim_sfr(SFR_TRISF))
+#define TRISFbits  (*(volatile TRISFBITS *)sim_sfr(SFR_TRISF))
+#define PORTF      (*sim_sfr(SFR_PORTF))
+#define PORTFbits  (*(volatile PORTFBITS *)sim_sfr(SFR_PORTF))
+#define LATF       (*sim_sfr(SFR_LATF))
+#define LATFbits   (*(volatile LATFBITS *)sim_sfr(SFR_LATF))
+#define TRISG      (*sim_sfr(SFR_TRISG))
+#define TRISGbits  (*(volatile TRISGBITS *)sim_sfr(SFR_TRISG))
+#define PORTG      (*sim_sfr(SFR_PORTG))
+#define PORTGbits  (*(volatile PORTGBITS *)sim_sfr(SFR_PORTG))
+#define LATG       (*sim_sfr(SFR_LATG))
+#define LATGbits   (*(volatile LATGBITS *)sim_sfr(SFR_LATG))
+#define OSCCON     (*sim_sfr(SFR_OSCCON))
+#define OSCCONbits (*(volatile OSCCONBITS *)sim_sfr(SFR_OSCCON))
+#define CLKDIV     (*sim_sfr(SFR_CLKDIV))
+#define CLKDIVbits (*(volatile CLKDIVBITS *)sim_sfr(SFR_CLKDIV))
+#define PMD1       (*sim_sfr(SFR_PMD1))
+#define PMD1bits   (*(volatile PMD1BITS *)sim_sfr(SFR_PMD1))
+#define PMD2       (*sim_sfr(SFR_PMD2))
+#define PMD2bits   (*(volatile PMD2BITS *)sim_sfr(SFR_PMD2))
+#define PMD3       (*sim_sfr(SFR_PMD3))
+#define PMD3bits   (*(volatile PMD3BITS *)sim_sfr(SFR_PMD3))
+#endif
@@ -0,0 +1,24 @@
+/*
+ * File:   sim_petla.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Dolaczany przed kazdym plikiem firmware'u (-include w Makefile).
+ * Petla czekajaca na flage ustawiana w przerwaniu nie dotyka rejestrow,
+ * wiec bez tej podmiany wirtualny czas by stanal. Naglowki biblioteki
+ * standardowej sa wlaczone wczesniej, zeby makro ich nie objelo.
+ */
+
+#ifndef SIM_PETLA_H
+#define SIM_PETLA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void sim_petla(void);
+
+#define while(warunek)  while (sim_petla(), (warunek))
+
+#endif // SIM_PETLA_H
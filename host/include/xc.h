@@ -0,0 +1,30 @@
+/*
+ * File:   xc.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Zamiennik naglowka XC16 przy budowaniu na PC (katalog host/).
+ * Atrybuty przerwan znikaja, a instrukcje procesora przechodza przez
+ * model (sim.c), zeby liczyly wirtualny czas.
+ */
+
+#ifndef XC_H
+#define XC_H
+
+#include "p24FJ128GA010.h"
+
+// __attribute__((interrupt, no_auto_psv)) -> __attribute__((, ))
+#define interrupt
+#define auto_psv
+#define no_auto_psv
+
+void sim_nop(void);
+void sim_idle(void);
+void sim_sleep(void);
+
+#define Nop()       sim_nop()
+#define Idle()      sim_idle()
+#define Sleep()     sim_sleep()
+#define ClrWdt()
+#define asm(x)      sim_nop()
+
+#endif // XC_H
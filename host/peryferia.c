@@ -0,0 +1,804 @@
+/*
+ * File:   peryferia.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Model peryferiow uzywanych w projektach: Timer1-5 (takze w trybie
+ * 32-bitowym), Change Notification, Input Capture 1-8, ADC1,
+ * komparatory z CVREF, PMP
+ * z wyswietlaczem HD44780, porty oraz wylaczanie modulow przez PMD1-3.
+ * Wszystko liczy sie leniwie - peryferia_dogon() nadrabia czas od
+ * poprzedniego wywolania, a peryferia_nastepne() podaje chwile
+ * najblizszego zdarzenia, do ktorej model moze przeskoczyc w Idle().
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+#define BIT(n)      (1u << (n))
+
+#define PORT(p)     (SFR_PORTA + 3 * (p))   // TRISx, PORTx, LATx po kolei
+#define LAT(p)      (SFR_LATA + 3 * (p))
+#define TRIS(p)     (SFR_TRISA + 3 * (p))
+
+// Szerokosc wyswietlacza w sladzie (Explorer16: 16x2)
+#ifndef SIM_LCD_KOLUMNY
+#define SIM_LCD_KOLUMNY     16
+#endif
+
+/******************************************************************************
+ * Timery
+ ******************************************************************************/
+#define TON         BIT(15)
+#define TCS         BIT(1)
+#define T32         BIT(3)
+
+static const uint16_t preskalery[4] = { 1, 8, 64, 256 };
+
+typedef struct {
+    int con, tmr, pr;
+    int ifs, bit;               // flaga przerwania
+    uint32_t reszta;            // Tcy, ktore nie zlozyly sie jeszcze w impuls
+    uint64_t ostatnio;          // do kiedy timer jest policzony
+    uint64_t dopasowania;
+} licznik_t;
+
+static licznik_t timery[6] = {
+    { 0 },
+    { SFR_T1CON, SFR_TMR1, SFR_PR1, SFR_IFS0,  3 },
+    { SFR_T2CON, SFR_TMR2, SFR_PR2, SFR_IFS0,  7 },
+    { SFR_T3CON, SFR_TMR3, SFR_PR3, SFR_IFS0,  8 },
+    { SFR_T4CON, SFR_TMR4, SFR_PR4, SFR_IFS1, 11 },
+    { SFR_T5CON, SFR_TMR5, SFR_PR5, SFR_IFS1, 12 },
+};
+
+// Timer2 z T32 liczy razem z Timer3 (Timer4 z Timer5), flaga i ADC
+// korzystaja wtedy z timera starszego slowa
+static int glowny32(int n) {
+    return (n == 2 || n == 4) && (sim_rej[timery[n].con] & T32);
+}
+
+static int podrzedny32(int n) {
+    return (n == 3 || n == 5) && glowny32(n - 1);
+}
+
+static int timer_liczy(int n) {
+    uint16_t con = sim_rej[timery[n].con];
+    // W Sleep zegar Tcy stoi - liczylby tylko timer z zewnetrznym zegarem
+    return (con & TON) && !(con & TCS) && !podrzedny32(n) && !sim_uspiony;
+}
+
+static uint64_t timer_stan(int n) {
+    if(glowny32(n)) {
+        return ((uint64_t)sim_rej[timery[n + 1].tmr] << 16) | sim_rej[timery[n].tmr];
+    }
+    return sim_rej[timery[n].tmr];
+}
+
+static uint64_t timer_okres(int n) {
+    if(glowny32(n)) {
+        return ((uint64_t)sim_rej[timery[n + 1].pr] << 16) | sim_rej[timery[n].pr];
+    }
+    return sim_rej[timery[n].pr];
+}
+
+static void adc_wyzwolenie_timer3(void);
+
+// n impulsow: TMR rowne PR zeruje licznik i ustawia flage, powyzej PR
+// licznik idzie do przepelnienia bez flagi
+static void timer_impulsy(int n, uint64_t impulsy) {
+    uint64_t maks = glowny32(n) ? 0xFFFFFFFFULL : 0xFFFFULL;
+    uint64_t t = timer_stan(n);
+    uint64_t pr = timer_okres(n);
+    uint64_t ile = 0;
+    int flaga = glowny32(n) ? n + 1 : n;
+
+    if(t > pr) {
+        if(impulsy <= maks - t) {
+            t += impulsy;
+            impulsy = 0;
+        } else {
+            impulsy -= maks - t + 1;
+            t = 0;
+        }
+    }
+    if(impulsy > pr - t) {
+        impulsy -= pr - t + 1;
+        ile = 1 + impulsy / (pr + 1);
+        t = impulsy % (pr + 1);
+    } else {
+        t += impulsy;
+    }
+
+    sim_rej[timery[n].tmr] = (uint16_t)t;
+    if(glowny32(n)) {
+        sim_rej[timery[n + 1].tmr] = (uint16_t)(t >> 16);
+    }
+    if(ile) {
+        timery[flaga].dopasowania += ile;
+        sim_rej[timery[flaga].ifs] |= BIT(timery[flaga].bit);
+        if(flaga == 3) {
+            adc_wyzwolenie_timer3();
+        }
+    }
+}
+
+static void timer_dogon(int n) {
+    licznik_t *t = &timery[n];
+    uint64_t dt = sim_czas - t->ostatnio;
+    uint16_t p;
+    uint64_t suma;
+
+    t->ostatnio = sim_czas;
+    if(!timer_liczy(n) || dt == 0) {
+        return;
+    }
+    p = preskalery[(sim_rej[t->con] >> 4) & 3];
+    suma = t->reszta + dt;
+    t->reszta = suma % p;
+    if(suma / p) {
+        timer_impulsy(n, suma / p);
+    }
+}
+
+// Chwila najblizszego dopasowania z PR
+static uint64_t timer_nastepne(int n) {
+    licznik_t *t = &timery[n];
+    uint64_t maks = glowny32(n) ? 0xFFFFFFFFULL : 0xFFFFULL;
+    uint64_t tmr = timer_stan(n);
+    uint64_t pr = timer_okres(n);
+    uint64_t impulsy;
+
+    if(!timer_liczy(n)) {
+        return SIM_BRAK_ZDARZENIA;
+    }
+    impulsy = (tmr <= pr) ? pr - tmr + 1 : (maks - tmr + 1) + pr + 1;
+    return sim_czas + impulsy * preskalery[(sim_rej[t->con] >> 4) & 3] - t->reszta;
+}
+
+/******************************************************************************
+ * Change Notification (przyciski Explorer16 i wejscia z rezystorami)
+ ******************************************************************************/
+typedef struct {
+    uint8_t port, bit, cn;
+} cn_pin_t;
+
+static const cn_pin_t cn_piny[] = {
+    { 1, 5, 7 },                // RB5 (AN5, potencjometr)
+    { 3, 4, 13 }, { 3, 5, 14 }, { 3, 6, 15 }, { 3, 7, 16 },
+    { 3, 13, 19 }, { 3, 14, 20 }, { 3, 15, 21 },
+};
+
+static void ic_zbocze(int n, int narastajace);
+
+static int cn_wlaczony(int cn) {
+    return cn < 16 ? (sim_rej[SFR_CNEN1] & BIT(cn)) != 0
+                   : (sim_rej[SFR_CNEN2] & BIT(cn - 16)) != 0;
+}
+
+void sim_pin(int port, int bit, int wartosc) {
+    uint16_t stara = sim_rej[PORT(port)];
+    unsigned i;
+
+    if(wartosc) {
+        sim_rej[PORT(port)] |= BIT(bit);
+    } else {
+        sim_rej[PORT(port)] &= ~BIT(bit);
+    }
+    if(stara == sim_rej[PORT(port)]) {
+        return;
+    }
+    if(port == 3 && bit >= 8) {
+        ic_zbocze(bit - 8, wartosc);    // IC1..IC8 na RD8..RD15
+    }
+    for(i = 0; i < sizeof(cn_piny) / sizeof(cn_piny[0]); i++) {
+        if(cn_piny[i].port == port && cn_piny[i].bit == bit && cn_wlaczony(cn_piny[i].cn)) {
+            sim_rej[SFR_IFS1] |= BIT(3);    // CNIF
+        }
+    }
+}
+
+/******************************************************************************
+ * Input Capture 1-8 - zatrzask TMR2 albo TMR3 na zboczu, bufor FIFO
+ * 4 slow; odczyt ICxBUF zdejmuje najstarszy wpis
+ ******************************************************************************/
+#define ICM(con)    ((con) & 7)
+#define ICBNE       BIT(3)
+#define ICOV        BIT(4)
+#define ICI(con)    (((con) >> 5) & 3)
+#define ICTMR       BIT(7)
+#define IC_CON(n)   (SFR_IC1CON + 2 * (n))
+#define IC_BUF(n)   (SFR_IC1BUF + 2 * (n))
+#define IC_FIFO     4
+
+typedef struct {
+    uint16_t fifo[IC_FIFO];
+    int ile;
+    int zbocza;                 // tryby co 4. i co 16. zbocze
+    int zatrzaski;              // od ostatniej flagi (ICI)
+} wychwyt_t;
+
+static wychwyt_t wychwyty[8];
+static const uint8_t ic_flagi[8][2] = {     // rejestr IFS (0-2) i bit
+    { 0, 1 }, { 0, 5 }, { 2, 5 }, { 2, 6 }, { 2, 7 }, { 2, 8 }, { 1, 6 }, { 1, 7 },
+};
+static uint64_t ic_zatrzaski;
+
+static void ic_zbocze(int n, int narastajace) {
+    wychwyt_t *w = &wychwyty[n];
+    uint16_t con = sim_rej[IC_CON(n)];
+
+    switch(ICM(con)) {
+        case 1:
+            break;
+        case 2:
+            if(narastajace) {
+                return;
+            }
+            break;
+        case 3:
+            if(!narastajace) {
+                return;
+            }
+            break;
+        case 4:
+        case 5:
+            if(!narastajace || ++w->zbocza < (ICM(con) == 4 ? 4 : 16)) {
+                return;
+            }
+            w->zbocza = 0;
+            break;
+        default:
+            return;
+    }
+
+    // Pelny bufor - zatrzask przepada, zostaje ICOV
+    if(w->ile == IC_FIFO) {
+        sim_rej[IC_CON(n)] |= ICOV;
+        return;
+    }
+    timer_dogon(2);
+    timer_dogon(3);
+    w->fifo[w->ile++] = sim_rej[(con & ICTMR) ? SFR_TMR2 : SFR_TMR3];
+    sim_rej[IC_CON(n)] |= ICBNE;
+    ic_zatrzaski++;
+    sim_slad(sim_czas, "IC%d  zatrzask 0x%04X", n + 1, w->fifo[w->ile - 1]);
+
+    if(++w->zatrzaski > ICI(con)) {
+        w->zatrzaski = 0;
+        sim_rej[SFR_IFS0 + ic_flagi[n][0]] |= BIT(ic_flagi[n][1]);
+    }
+}
+
+static void ic_odczyt(int n) {
+    wychwyt_t *w = &wychwyty[n];
+
+    if(w->ile == 0) {
+        return;                 // pusty bufor - ostatnia wartosc
+    }
+    sim_rej[IC_BUF(n)] = w->fifo[0];
+    memmove(w->fifo, w->fifo + 1, (IC_FIFO - 1) * sizeof(w->fifo[0]));
+    if(--w->ile == 0) {
+        sim_rej[IC_CON(n)] &= ~(ICBNE | ICOV);
+    }
+}
+
+// ICBNE i ICOV tylko do odczytu, ICM = 000 zeruje modul
+static void ic_zapis(int n, uint16_t stara) {
+    sim_rej[IC_CON(n)] = (sim_rej[IC_CON(n)] & ~(ICBNE | ICOV)) | (stara & (ICBNE | ICOV));
+    if(ICM(sim_rej[IC_CON(n)]) == 0) {
+        memset(&wychwyty[n], 0, sizeof(wychwyty[n]));
+        sim_rej[IC_CON(n)] &= ~(ICBNE | ICOV);
+    }
+}
+
+/******************************************************************************
+ * ADC1 - 10 bitow, konwersja 12 Tad
+ ******************************************************************************/
+#define ADON        BIT(15)
+#define ASAM        BIT(2)
+#define SAMP        BIT(1)
+#define DONE        BIT(0)
+#define SSRC(c1)    (((c1) >> 5) & 7)
+
+enum { ADC_STOP, ADC_PROBKOWANIE, ADC_KONWERSJA };
+
+static uint16_t analog[16];
+static int adc_faza = ADC_STOP;
+static uint64_t adc_termin = SIM_BRAK_ZDARZENIA;
+static int adc_kanal;
+static int adc_indeks;          // nastepna komorka ADC1BUFx
+static int adc_probki;          // probki od ostatniego przerwania
+static int adc_skan;            // pozycja w AD1CSSL
+static int adc_mux_b;           // ALTS - nastepna probka z MUX B
+static uint64_t adc_konwersje;
+
+static void komparatory(void);
+
+void sim_analog(int kanal, uint16_t wartosc) {
+    analog[kanal & 15] = wartosc > 1023 ? 1023 : wartosc;
+    komparatory();
+}
+
+uint16_t sim_analog_wartosc(int kanal) {
+    return analog[kanal & 15];
+}
+
+static uint64_t adc_tad(void) {
+    if(sim_rej[SFR_AD1CON3] & BIT(15)) {
+        return 1;               // ADRC - wewnetrzny RC, Tad ok. 250 ns
+    }
+    return (sim_rej[SFR_AD1CON3] & 0xFF) + 1;
+}
+
+static void adc_start_probkowania(uint64_t od) {
+    adc_faza = ADC_PROBKOWANIE;
+    sim_rej[SFR_AD1CON1] |= SAMP;
+    if(SSRC(sim_rej[SFR_AD1CON1]) == 7) {
+        uint64_t samc = (sim_rej[SFR_AD1CON3] >> 8) & 0x1F;
+        adc_termin = od + (samc ? samc : 1) * adc_tad();
+    } else {
+        adc_termin = SIM_BRAK_ZDARZENIA;
+    }
+}
+
+static int adc_wybierz_kanal(void) {
+    uint16_t con2 = sim_rej[SFR_AD1CON2];
+    uint16_t chs = sim_rej[SFR_AD1CHS];
+    uint16_t cssl = sim_rej[SFR_AD1CSSL];
+    int i;
+
+    if((con2 & BIT(10)) && cssl) {          // CSCNA - skanowanie
+        for(i = 0; i < 16; i++) {
+            int k = (adc_skan + i) & 15;
+            if(cssl & BIT(k)) {
+                adc_skan = k + 1;
+                return k;
+            }
+        }
+    }
+    if((con2 & BIT(0)) && adc_mux_b) {      // ALTS
+        adc_mux_b = 0;
+        return (chs >> 8) & 15;
+    }
+    adc_mux_b = (con2 & BIT(0)) != 0;
+    return chs & 15;
+}
+
+static void adc_start_konwersji(uint64_t od) {
+    adc_faza = ADC_KONWERSJA;
+    sim_rej[SFR_AD1CON1] &= ~(SAMP | DONE);
+    adc_kanal = adc_wybierz_kanal();
+    adc_termin = od + 12 * adc_tad();
+}
+
+static void adc_koniec_konwersji(uint64_t kiedy) {
+    uint16_t con2 = sim_rej[SFR_AD1CON2];
+    int smpi = ((con2 >> 2) & 15) + 1;
+
+    sim_rej[SFR_ADC1BUF0 + (adc_indeks & 15)] = analog[adc_kanal];
+    sim_rej[SFR_AD1CON1] |= DONE;
+    adc_konwersje++;
+    adc_indeks++;
+
+    if(++adc_probki >= smpi) {
+        adc_probki = 0;
+        adc_skan = 0;
+        adc_mux_b = 0;
+        sim_rej[SFR_IFS0] |= BIT(13);       // AD1IF
+        if(con2 & BIT(1)) {                 // BUFM - dwie polowki po 8
+            sim_rej[SFR_AD1CON2] ^= BIT(7); // BUFS
+            adc_indeks = (sim_rej[SFR_AD1CON2] & BIT(7)) ? 8 : 0;
+        } else {
+            adc_indeks = 0;
+        }
+    }
+
+    if(sim_rej[SFR_AD1CON1] & ASAM) {
+        adc_start_probkowania(kiedy);
+    } else {
+        adc_faza = ADC_STOP;
+        adc_termin = SIM_BRAK_ZDARZENIA;
+    }
+}
+
+static void adc_dogon(void) {
+    while(adc_termin <= sim_czas) {
+        uint64_t t = adc_termin;
+        if(adc_faza == ADC_PROBKOWANIE) {
+            adc_start_konwersji(t);
+        } else if(adc_faza == ADC_KONWERSJA) {
+            adc_koniec_konwersji(t);
+        } else {
+            adc_termin = SIM_BRAK_ZDARZENIA;
+        }
+    }
+}
+
+// SSRC = 010 - dopasowanie Timer3 konczy probkowanie
+static void adc_wyzwolenie_timer3(void) {
+    uint16_t c1 = sim_rej[SFR_AD1CON1];
+
+    if((c1 & ADON) && SSRC(c1) == 2 && adc_faza == ADC_PROBKOWANIE) {
+        adc_start_konwersji(sim_czas);
+    }
+}
+
+static void adc_zapis(uint16_t stara) {
+    uint16_t c1 = sim_rej[SFR_AD1CON1];
+
+    if(!(c1 & ADON)) {
+        adc_faza = ADC_STOP;
+        adc_termin = SIM_BRAK_ZDARZENIA;
+        return;
+    }
+    if((c1 & SAMP) && !(stara & SAMP)) {
+        sim_rej[SFR_AD1CON1] &= ~DONE;
+        adc_start_probkowania(sim_czas);
+    } else if(!(c1 & SAMP) && (stara & SAMP) && adc_faza == ADC_PROBKOWANIE) {
+        // Programowe zakonczenie probkowania startuje konwersje takze przy
+        // SSRC = 111 (zad_2/3/5 zeruja SAMP przed koncem licznika SAMC)
+        adc_start_konwersji(sim_czas);
+    } else if((c1 & ASAM) && adc_faza == ADC_STOP && (!(stara & ASAM) || !(stara & ADON))) {
+        adc_start_probkowania(sim_czas);
+    }
+}
+
+/******************************************************************************
+ * Komparatory i CVREF (C1IN- = AN4, C1IN+ = AN5, C2IN- = AN2, C2IN+ = AN3)
+ ******************************************************************************/
+#define CVREN       BIT(7)
+#define CVRR        BIT(5)
+#define CM_OUT      (BIT(6) | BIT(7))
+
+static const uint8_t cm_we_minus[2] = { 4, 2 };
+static const uint8_t cm_we_plus[2] = { 5, 3 };
+static uint64_t cm_zmiany;
+
+// Napiecia w jednostkach AVDD / (1023 * 768): 768 to wspolna wielokrotnosc
+// krokow CVREF (1/24 i 1/32 AVDD), 1023 - pelny zakres ADC
+static uint32_t cm_wejscie(int kanal) {
+    return analog[kanal] * 768UL;
+}
+
+static uint32_t cm_cvref(void) {
+    uint16_t cvr = sim_rej[SFR_CVRCON];
+
+    if(!(cvr & CVREN)) {
+        return 0;
+    }
+    if(cvr & CVRR) {
+        return (cvr & 15) * 32UL * 1023;            // CVR/24 AVDD
+    }
+    return (192 + (cvr & 15) * 24UL) * 1023;        // 1/4 AVDD + CVR/32 AVDD
+}
+
+// Wyjscia CxOUT z biezacych napiec. Zmiana wyjscia wlaczonego komparatora
+// ustawia CxEVT i CMIF (przerwanie budzi takze ze Sleep)
+static void komparatory(void) {
+    uint16_t cm = sim_rej[SFR_CMCON];
+    uint16_t wy = 0;
+    int n;
+
+    for(n = 0; n < 2; n++) {
+        uint32_t plus, minus;
+
+        if(!(cm & BIT(10 + n))) {                   // CxEN
+            continue;
+        }
+        plus = (cm & BIT(2 * n)) ? cm_wejscie(cm_we_plus[n]) : cm_cvref();
+        minus = cm_wejscie((cm & BIT(2 * n + 1)) ? cm_we_plus[n] : cm_we_minus[n]);
+        if((plus > minus) != ((cm & BIT(4 + n)) != 0)) {    // CxINV
+            wy |= BIT(6 + n);
+        }
+    }
+    for(n = 0; n < 2; n++) {
+        if((wy ^ cm) & BIT(6 + n)) {
+            cm |= BIT(12 + n);                      // CxEVT
+            sim_rej[SFR_IFS1] |= BIT(2);            // CMIF
+            cm_zmiany++;
+        }
+    }
+    sim_rej[SFR_CMCON] = (cm & ~CM_OUT) | wy;
+}
+
+/******************************************************************************
+ * PMP + HD44780 (RS na PMA0, 8 bitow)
+ ******************************************************************************/
+#define LCD_US(us)  ((uint64_t)(us) * (FCY / 1000000UL))
+
+static uint8_t ddram[0x80];
+static uint8_t lcd_ac = 0;
+static int lcd_wstecz = 0;          // I/D = 0
+static uint64_t lcd_zajety_do = 0;
+static uint16_t pmp_zatrzask = 0;
+static uint64_t lcd_zapisy = 0, lcd_naruszenia = 0;
+static uint64_t lata_zmiany = 0;
+
+// Dwuliniowy adres DDRAM: 0x00-0x27 i 0x40-0x67
+static uint8_t lcd_nastepny_adres(uint8_t a) {
+    if(lcd_wstecz) {
+        return a == 0x00 ? 0x67 : a == 0x40 ? 0x27 : a - 1;
+    }
+    return a == 0x27 ? 0x40 : a == 0x67 ? 0x00 : a + 1;
+}
+
+static void lcd_zapis(int rs, uint8_t d) {
+    uint64_t czas = LCD_US(37);
+
+    lcd_zapisy++;
+    if(sim_czas < lcd_zajety_do) {
+        lcd_naruszenia++;
+        sim_slad(sim_czas, "LCD  NARUSZENIE: zapis %.1f us przed koncem poprzedniej instrukcji",
+                 (double)(lcd_zajety_do - sim_czas) / (FCY / 1000000UL));
+    }
+
+    if(rs) {
+        sim_slad(sim_czas, "LCD  D 0x%02X '%c'  adres 0x%02X", d, (d >= 0x20 && d < 0x7F) ? d : '?', lcd_ac);
+        ddram[lcd_ac & 0x7F] = d;
+        lcd_ac = lcd_nastepny_adres(lcd_ac);
+    } else if(d & 0x80) {
+        lcd_ac = d & 0x7F;
+        sim_slad(sim_czas, "LCD  C 0x%02X adres DDRAM 0x%02X", d, lcd_ac);
+    } else if(d & 0x40) {
+        sim_slad(sim_czas, "LCD  C 0x%02X adres CGRAM", d);
+    } else if(d & 0x20) {
+        sim_slad(sim_czas, "LCD  C 0x%02X funkcja", d);
+    } else if(d & 0x10) {
+        sim_slad(sim_czas, "LCD  C 0x%02X przesuniecie", d);
+    } else if(d & 0x08) {
+        sim_slad(sim_czas, "LCD  C 0x%02X wyswietlacz", d);
+    } else if(d & 0x04) {
+        lcd_wstecz = !(d & 0x02);
+        sim_slad(sim_czas, "LCD  C 0x%02X tryb wpisu", d);
+    } else if(d & 0x02) {
+        lcd_ac = 0;
+        czas = LCD_US(1520);
+        sim_slad(sim_czas, "LCD  C 0x%02X powrot", d);
+    } else if(d & 0x01) {
+        memset(ddram, ' ', sizeof(ddram));
+        lcd_ac = 0;
+        lcd_wstecz = 0;
+        czas = LCD_US(1520);
+        sim_slad(sim_czas, "LCD  C 0x%02X czyszczenie", d);
+    }
+    lcd_zajety_do = sim_czas + czas;
+}
+
+static uint8_t lcd_odczyt(int rs) {
+    uint8_t d;
+
+    if(!rs) {
+        return (sim_czas < lcd_zajety_do ? 0x80 : 0x00) | lcd_ac;
+    }
+    d = ddram[lcd_ac & 0x7F];
+    lcd_ac = lcd_nastepny_adres(lcd_ac);
+    return d;
+}
+
+void sim_pmp_zapis(uint16_t dana) {
+    sim_dostep();
+    if(!(sim_rej[SFR_PMCON] & BIT(15))) {
+        sim_blad("zapis PMDIN1 przy wylaczonym PMP (PMCONbits.PMPEN = 0)");
+    }
+    sim_rej[SFR_PMDIN1] = dana;
+    lcd_zapis(sim_rej[SFR_PMADDR] & 1, (uint8_t)dana);
+}
+
+// Odczyt PMDIN1 zwraca wynik poprzedniego cyklu i zaczyna nastepny
+uint16_t sim_pmp_odczyt(void) {
+    uint16_t w;
+
+    sim_dostep();
+    w = pmp_zatrzask;
+    pmp_zatrzask = lcd_odczyt(sim_rej[SFR_PMADDR] & 1);
+    sim_rej[SFR_PMDIN1] = w;
+    return w;
+}
+
+void sim_ekran(void) {
+    static const uint8_t wiersze[2] = { 0x00, 0x40 };
+    char tekst[SIM_LCD_KOLUMNY + 1];
+    int w, k;
+
+    for(w = 0; w < 2; w++) {
+        for(k = 0; k < SIM_LCD_KOLUMNY; k++) {
+            uint8_t z = ddram[wiersze[w] + k];
+            tekst[k] = (z >= 0x20 && z < 0x7F) ? z : '?';
+        }
+        tekst[SIM_LCD_KOLUMNY] = '\0';
+        sim_slad(sim_czas, "EKRAN |%s|", tekst);
+    }
+}
+
+/******************************************************************************
+ * PMD - modul wylaczony bitem xxxMD jest w resecie, zapisy do jego
+ * rejestrow nie dzialaja (tu: sa zliczane jako naruszenia)
+ ******************************************************************************/
+static uint64_t pmd_naruszenia = 0;
+
+static int pmd_wylaczony(int rej) {
+    uint16_t pmd1 = sim_rej[SFR_PMD1], pmd2 = sim_rej[SFR_PMD2], pmd3 = sim_rej[SFR_PMD3];
+    int n;
+
+    for(n = 1; n <= 5; n++) {
+        if(rej == timery[n].con || rej == timery[n].tmr || rej == timery[n].pr) {
+            return (pmd1 & BIT(10 + n)) != 0;           // T1MD..T5MD
+        }
+    }
+    if(rej == SFR_TMR3HLD || rej == SFR_TMR5HLD) {
+        return (pmd1 & BIT(rej == SFR_TMR3HLD ? 13 : 15)) != 0;
+    }
+    if((rej >= SFR_ADC1BUF0 && rej <= SFR_AD1CHS) || rej == SFR_AD1CSSL) {
+        return (pmd1 & BIT(0)) != 0;                    // ADC1MD
+    }
+    if(rej >= SFR_PMCON && rej <= SFR_PMSTAT) {
+        return (pmd3 & BIT(8)) != 0;                    // PMPMD
+    }
+    if(rej == SFR_CMCON) {
+        return (pmd3 & BIT(10)) != 0;                   // CMPMD
+    }
+    if(rej >= SFR_IC1BUF && rej <= SFR_IC8CON) {
+        return (pmd2 & BIT((rej - SFR_IC1BUF) / 2)) != 0;  // IC1MD..IC8MD
+    }
+    return 0;
+}
+
+// Ustawienie bitu xxxMD zeruje rejestry modulu
+static void pmd_zapis(void) {
+    int r;
+
+    for(r = 0; r < SFR_LICZBA; r++) {
+        if(pmd_wylaczony(r)) {
+            sim_rej[r] = 0;
+        }
+    }
+    if(sim_rej[SFR_PMD1] & BIT(0)) {
+        adc_faza = ADC_STOP;
+        adc_termin = SIM_BRAK_ZDARZENIA;
+    }
+    for(r = 0; r < 8; r++) {
+        if(sim_rej[SFR_PMD2] & BIT(r)) {
+            memset(&wychwyty[r], 0, sizeof(wychwyty[r]));
+        }
+    }
+}
+
+/******************************************************************************
+ * Wspolne
+ ******************************************************************************/
+void peryferia_reset(void) {
+    int i;
+
+    memset(sim_rej, 0, sizeof(sim_rej));
+    for(i = SFR_IPC0; i <= SFR_IPC11; i++) {
+        sim_rej[i] = 0x4444;    // priorytet 4 dla wszystkich zrodel
+    }
+    for(i = 0; i < 7; i++) {
+        sim_rej[TRIS(i)] = 0xFFFF;
+        sim_rej[PORT(i)] = 0xFFFF;      // wejscia podciagniete do 1
+    }
+    memset(ddram, ' ', sizeof(ddram));
+}
+
+void peryferia_dogon(void) {
+    int n;
+
+    for(n = 1; n <= 5; n++) {
+        timer_dogon(n);
+    }
+    adc_dogon();
+}
+
+uint64_t peryferia_nastepne(void) {
+    uint64_t t = adc_termin;
+    uint16_t c1 = sim_rej[SFR_AD1CON1];
+    int n;
+
+    // Zdarzenie tylko dla timerow, ktorych dopasowanie cos wywoluje -
+    // flage bez przerwania firmware i tak odczyta przez sim_sfr()
+    for(n = 1; n <= 5; n++) {
+        int flaga = glowny32(n) ? n + 1 : n;
+        int ie = sim_rej[timery[flaga].ifs + (SFR_IEC0 - SFR_IFS0)] & BIT(timery[flaga].bit);
+        int adc = flaga == 3 && (c1 & ADON) && SSRC(c1) == 2;
+        if(ie || adc) {
+            uint64_t m = timer_nastepne(n);
+            if(m < t) {
+                t = m;
+            }
+        }
+    }
+    return t;
+}
+
+void peryferia_odczyt(int rej) {
+    // 32 bity: odczyt mlodszego slowa zatrzaskuje starsze w TMRxHLD
+    if(rej == SFR_TMR2 && glowny32(2)) {
+        sim_rej[SFR_TMR3HLD] = sim_rej[SFR_TMR3];
+    } else if(rej == SFR_TMR4 && glowny32(4)) {
+        sim_rej[SFR_TMR5HLD] = sim_rej[SFR_TMR5];
+    }
+    if(rej >= SFR_IC1BUF && rej <= SFR_IC8CON && (rej - SFR_IC1BUF) % 2 == 0) {
+        ic_odczyt((rej - SFR_IC1BUF) / 2);
+    }
+}
+
+static void slad_lata(uint16_t lata, uint64_t kiedy) {
+    char diody[9];
+    int i;
+
+    for(i = 0; i < 8; i++) {
+        diody[i] = (lata & BIT(7 - i)) ? '#' : '.';
+    }
+    diody[8] = '\0';
+    sim_slad(kiedy, "LATA 0x%02X %s", lata & 0xFF, diody);
+}
+
+void peryferia_zapis(int rej, uint16_t stara, uint64_t kiedy) {
+    int n, p;
+
+    if(pmd_wylaczony(rej)) {
+        sim_rej[rej] = stara;
+        pmd_naruszenia++;
+        sim_slad(kiedy, "PMD  NARUSZENIE zapis do wylaczonego modulu (rejestr %d)", rej);
+        return;
+    }
+    if(rej == SFR_PMD1 || rej == SFR_PMD2 || rej == SFR_PMD3) {
+        pmd_zapis();
+    }
+
+    for(n = 1; n <= 5; n++) {
+        if(rej == timery[n].tmr || rej == timery[n].con) {
+            timery[n].reszta = 0;       // zapis TMRx/TxCON zeruje preskaler
+        }
+    }
+    if(rej == SFR_TMR2 && glowny32(2)) {
+        sim_rej[SFR_TMR3] = sim_rej[SFR_TMR3HLD];
+    } else if(rej == SFR_TMR4 && glowny32(4)) {
+        sim_rej[SFR_TMR5] = sim_rej[SFR_TMR5HLD];
+    }
+
+    if(rej >= SFR_IC1BUF && rej <= SFR_IC8CON && (rej - SFR_IC1BUF) % 2 == 1) {
+        ic_zapis((rej - SFR_IC1BUF) / 2, stara);
+    }
+
+    if(rej == SFR_AD1CON1) {
+        adc_zapis(stara);
+    }
+
+    // CxOUT tylko do odczytu
+    if(rej == SFR_CMCON) {
+        sim_rej[SFR_CMCON] = (sim_rej[SFR_CMCON] & ~CM_OUT) | (stara & CM_OUT);
+    }
+    if(rej == SFR_CMCON || rej == SFR_CVRCON) {
+        komparatory();
+    }
+
+    // Zapis do PORTx trafia do LATx, piny wyjsciowe ida za LATx
+    for(p = 0; p < 7; p++) {
+        if(rej == PORT(p)) {
+            uint16_t nowa = sim_rej[rej];
+            sim_rej[rej] = stara;
+            sim_rej[LAT(p)] = nowa;
+            rej = LAT(p);
+        }
+        if(rej == LAT(p)) {
+            uint16_t wy = ~sim_rej[TRIS(p)];
+            sim_rej[PORT(p)] = (sim_rej[PORT(p)] & ~wy) | (sim_rej[LAT(p)] & wy);
+            if(p == 0) {
+                lata_zmiany++;
+                slad_lata(sim_rej[SFR_LATA], kiedy);
+            }
+        }
+    }
+}
+
+void peryferia_podsumowanie(void) {
+    fprintf(stderr, "\nzmiany LATA      %12llu\n", (unsigned long long)lata_zmiany);
+    fprintf(stderr, "zatrzaski IC     %12llu\n", (unsigned long long)ic_zatrzaski);
+    fprintf(stderr, "konwersje ADC    %12llu\n", (unsigned long long)adc_konwersje);
+    fprintf(stderr, "zmiany komparat. %12llu\n", (unsigned long long)cm_zmiany);
+    fprintf(stderr, "zapisy LCD       %12llu\n", (unsigned long long)lcd_zapisy);
+    fprintf(stderr, "naruszenia LCD   %12llu\n", (unsigned long long)lcd_naruszenia);
+    fprintf(stderr, "naruszenia PMD   %12llu\n", (unsigned long long)pmd_naruszenia);
+}
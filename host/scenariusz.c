@@ -0,0 +1,293 @@
+/*
+ * File:   scenariusz.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Wejscia w wirtualnym czasie, wczytywane z pliku tekstowego:
+ *
+ *   <czas> [co <okres>] <polecenie> [argumenty]     # komentarz
+ *
+ * Czas jest bezwzgledny albo z '+' wzgledem poprzedniej linii, w ms lub
+ * z jednostka: 250us, 1.5s, 10min, 2h. "co" powtarza polecenie z danym
+ * okresem az do konca symulacji. Polecenia:
+ *
+ *   wcisnij RD6         przycisk (pin w stan 0)
+ *   pusc RD6            puszczenie (pin w stan 1)
+ *   klik RD6 [czas]     wcisniecie i puszczenie po czasie (domyslnie 100 ms)
+ *   pot 700             potencjometr Explorer16 (AN5), 0..1023
+ *   analog AN3 512      dowolne wejscie analogowe
+ *   pot 700 w 3s        narastanie (lub opadanie) liniowe od biezacej
+ *                       wartosci, tez dla analog
+ *   ekran               zawartosc LCD do sladu
+ *   koniec              koniec symulacji i podsumowanie
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#define DOMYSLNY_KONIEC     SIM_CYKLE_MS(10000)
+#define DOMYSLNY_KLIK       SIM_CYKLE_MS(100)
+#define KROK_RAMPY          SIM_CYKLE_MS(1)
+
+enum { WCISNIJ, PUSC, KLIK, POT, ANALOG, KROK, EKRAN };
+
+typedef struct {
+    uint64_t czas;
+    uint64_t okres;             // 0 - jednorazowo
+    uint64_t trwanie;           // klik, narastanie wejscia analogowego
+    int polecenie;
+    int a, b;                   // port i bit albo kanal i wartosc
+} zdarzenie_t;
+
+static zdarzenie_t *kolejka;    // posortowana po czasie
+static int liczba, pojemnosc;
+static uint64_t koniec = SIM_BRAK_ZDARZENIA;
+
+// Wstawienie za wszystkimi zdarzeniami o tym samym czasie
+static void dodaj(zdarzenie_t z) {
+    int i;
+
+    if(liczba == pojemnosc) {
+        pojemnosc = pojemnosc ? 2 * pojemnosc : 64;
+        kolejka = realloc(kolejka, pojemnosc * sizeof(zdarzenie_t));
+        if(kolejka == NULL) {
+            sim_blad("brak pamieci na scenariusz");
+        }
+    }
+    for(i = liczba; i > 0 && kolejka[i - 1].czas > z.czas; i--) {
+        kolejka[i] = kolejka[i - 1];
+    }
+    kolejka[i] = z;
+    liczba++;
+}
+
+static int czytaj_czas(const char *tekst, uint64_t *cykle) {
+    char *koniec_liczby;
+    double wartosc = strtod(tekst, &koniec_liczby);
+    double mnoznik;
+
+    if(koniec_liczby == tekst || wartosc < 0) {
+        return -1;
+    }
+    if(*koniec_liczby == '\0' || strcmp(koniec_liczby, "ms") == 0) {
+        mnoznik = FCY / 1000.0;
+    } else if(strcmp(koniec_liczby, "us") == 0) {
+        mnoznik = FCY / 1000000.0;
+    } else if(strcmp(koniec_liczby, "s") == 0) {
+        mnoznik = FCY;
+    } else if(strcmp(koniec_liczby, "min") == 0) {
+        mnoznik = 60.0 * FCY;
+    } else if(strcmp(koniec_liczby, "h") == 0) {
+        mnoznik = 3600.0 * FCY;
+    } else {
+        return -1;
+    }
+    *cykle = (uint64_t)(wartosc * mnoznik + 0.5);
+    return 0;
+}
+
+// "RD6" -> port 3, bit 6
+static int czytaj_pin(const char *tekst, int *port, int *bit) {
+    char *koniec_liczby;
+
+    if(tekst == NULL || toupper((unsigned char)tekst[0]) != 'R') {
+        return -1;
+    }
+    *port = toupper((unsigned char)tekst[1]) - 'A';
+    *bit = strtol(tekst + 2, &koniec_liczby, 10);
+    if(*port < 0 || *port > 6 || *bit < 0 || *bit > 15 || *koniec_liczby != '\0' || koniec_liczby == tekst + 2) {
+        return -1;
+    }
+    return 0;
+}
+
+static int czytaj_liczbe(const char *tekst, int min, int max, int *wynik) {
+    char *koniec_liczby;
+
+    if(tekst == NULL) {
+        return -1;
+    }
+    if(toupper((unsigned char)tekst[0]) == 'A' && toupper((unsigned char)tekst[1]) == 'N') {
+        tekst += 2;
+    }
+    *wynik = strtol(tekst, &koniec_liczby, 0);
+    return (koniec_liczby == tekst || *koniec_liczby != '\0' || *wynik < min || *wynik > max) ? -1 : 0;
+}
+
+// Opcjonalne "w <czas>" po wartosci wejscia analogowego
+static int czytaj_rampe(char **slowa, int n, int s, uint64_t *trwanie) {
+    *trwanie = 0;
+    if(s >= n) {
+        return 0;
+    }
+    if(s + 2 != n || strcmp(slowa[s], "w") != 0) {
+        return -1;
+    }
+    return czytaj_czas(slowa[s + 1], trwanie);
+}
+
+int scenariusz_wczytaj(const char *plik) {
+    FILE *f = fopen(plik, "r");
+    char linia[256];
+    uint64_t poprzedni = 0;
+    int numer = 0;
+
+    if(f == NULL) {
+        perror(plik);
+        return -1;
+    }
+    while(fgets(linia, sizeof(linia), f) != NULL) {
+        char *slowa[8];
+        int n = 0, s = 0;
+        char *p;
+        zdarzenie_t z = { 0 };
+        int blad = 0;
+
+        numer++;
+        if((p = strchr(linia, '#')) != NULL) {
+            *p = '\0';
+        }
+        for(p = strtok(linia, " \t\r\n"); p != NULL && n < 8; p = strtok(NULL, " \t\r\n")) {
+            slowa[n++] = p;
+        }
+        if(n == 0) {
+            continue;
+        }
+
+        if(slowa[0][0] == '+') {
+            blad |= czytaj_czas(slowa[0] + 1, &z.czas);
+            z.czas += poprzedni;
+        } else {
+            blad |= czytaj_czas(slowa[0], &z.czas);
+        }
+        poprzedni = z.czas;
+        s = 1;
+        if(s + 1 < n && strcmp(slowa[s], "co") == 0) {
+            blad |= czytaj_czas(slowa[s + 1], &z.okres);
+            blad |= z.okres == 0;
+            s += 2;
+        }
+        if(blad || s >= n) {
+            fprintf(stderr, "%s:%d: niepoprawny czas\n", plik, numer);
+            fclose(f);
+            return -1;
+        }
+
+        if(strcmp(slowa[s], "wcisnij") == 0 || strcmp(slowa[s], "pusc") == 0) {
+            z.polecenie = slowa[s][0] == 'w' ? WCISNIJ : PUSC;
+            blad = czytaj_pin(s + 1 < n ? slowa[s + 1] : NULL, &z.a, &z.b);
+        } else if(strcmp(slowa[s], "klik") == 0) {
+            z.polecenie = KLIK;
+            z.trwanie = DOMYSLNY_KLIK;
+            blad = czytaj_pin(s + 1 < n ? slowa[s + 1] : NULL, &z.a, &z.b);
+            if(s + 2 < n) {
+                blad |= czytaj_czas(slowa[s + 2], &z.trwanie);
+            }
+        } else if(strcmp(slowa[s], "pot") == 0) {
+            z.polecenie = ANALOG;
+            z.a = 5;
+            blad = czytaj_liczbe(s + 1 < n ? slowa[s + 1] : NULL, 0, 1023, &z.b);
+            blad |= czytaj_rampe(slowa, n, s + 2, &z.trwanie);
+        } else if(strcmp(slowa[s], "analog") == 0) {
+            z.polecenie = ANALOG;
+            blad = czytaj_liczbe(s + 1 < n ? slowa[s + 1] : NULL, 0, 15, &z.a);
+            blad |= czytaj_liczbe(s + 2 < n ? slowa[s + 2] : NULL, 0, 1023, &z.b);
+            blad |= czytaj_rampe(slowa, n, s + 3, &z.trwanie);
+        } else if(strcmp(slowa[s], "ekran") == 0) {
+            z.polecenie = EKRAN;
+        } else if(strcmp(slowa[s], "koniec") == 0) {
+            koniec = z.czas;
+            continue;
+        } else {
+            blad = -1;
+        }
+        if(blad) {
+            fprintf(stderr, "%s:%d: niepoprawne polecenie '%s'\n", plik, numer, slowa[s]);
+            fclose(f);
+            return -1;
+        }
+        dodaj(z);
+    }
+    fclose(f);
+    return 0;
+}
+
+uint64_t scenariusz_nastepne(void) {
+    return liczba ? kolejka[0].czas : SIM_BRAK_ZDARZENIA;
+}
+
+uint64_t scenariusz_koniec(void) {
+    if(koniec == SIM_BRAK_ZDARZENIA) {
+        fprintf(stderr, "sim: scenariusz bez 'koniec' - symulacja %.0f s\n", SIM_MS(DOMYSLNY_KONIEC) / 1000);
+        return DOMYSLNY_KONIEC;
+    }
+    return koniec;
+}
+
+// Narastanie rozpisane na kroki co KROK_RAMPY, bez sladu kazdego kroku
+static void rampa(zdarzenie_t z) {
+    int od = sim_analog_wartosc(z.a);
+    uint64_t kroki = z.trwanie / KROK_RAMPY;
+    uint64_t i;
+    zdarzenie_t krok = z;
+
+    sim_slad(sim_czas, "WEJ  AN%d = %d -> %d w %.0f ms", z.a, od, z.b, SIM_MS(z.trwanie));
+    krok.polecenie = KROK;
+    krok.okres = 0;
+    for(i = 1; i <= kroki; i++) {
+        krok.czas = z.czas + i * KROK_RAMPY;
+        krok.b = od + (int)((z.b - od) * (int64_t)i / (int64_t)kroki);
+        dodaj(krok);
+    }
+}
+
+void scenariusz_wykonaj(void) {
+    while(liczba && kolejka[0].czas <= sim_czas) {
+        zdarzenie_t z = kolejka[0];
+
+        liczba--;
+        memmove(&kolejka[0], &kolejka[1], liczba * sizeof(zdarzenie_t));
+
+        switch(z.polecenie) {
+            case WCISNIJ:
+                sim_slad(sim_czas, "WEJ  wcisnij R%c%d", 'A' + z.a, z.b);
+                sim_pin(z.a, z.b, 0);
+                break;
+            case PUSC:
+                sim_slad(sim_czas, "WEJ  pusc R%c%d", 'A' + z.a, z.b);
+                sim_pin(z.a, z.b, 1);
+                break;
+            case KLIK: {
+                zdarzenie_t puszczenie = z;
+                sim_slad(sim_czas, "WEJ  wcisnij R%c%d", 'A' + z.a, z.b);
+                sim_pin(z.a, z.b, 0);
+                puszczenie.polecenie = PUSC;
+                puszczenie.okres = 0;
+                puszczenie.czas = z.czas + z.trwanie;
+                dodaj(puszczenie);
+                break;
+            }
+            case ANALOG:
+                if(z.trwanie) {
+                    rampa(z);
+                    break;
+                }
+                sim_slad(sim_czas, "WEJ  AN%d = %d", z.a, z.b);
+                sim_analog(z.a, z.b);
+                break;
+            case KROK:
+                sim_analog(z.a, z.b);
+                break;
+            case EKRAN:
+                sim_ekran();
+                break;
+        }
+
+        if(z.okres) {
+            z.czas += z.okres;
+            dodaj(z);
+        }
+    }
+}
@@ -0,0 +1,398 @@
+/*
+ * File:   sim.c
+ * Author: Jakub Budzich - 169224
+ *
+ * Rdzen modelu: rejestry, wirtualny czas, kontroler przerwan, Idle()
+ * i statystyki. Firmware jest linkowany z main przemianowanym na
+ * firmware_main (Makefile), main ponizej wczytuje scenariusz i go wola.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+
+uint16_t sim_rej[SFR_LICZBA];
+uint64_t sim_czas = 0;
+int sim_cichy = 0;
+int sim_uspiony = 0;
+
+static FILE *slad;
+static uint64_t nastepne = SIM_BRAK_ZDARZENIA;  // najblizsze zdarzenie
+static uint64_t koniec;
+
+// Ostatni dostep do rejestru - zapis widac dopiero przy nastepnym wejsciu
+// do modelu, porownujac z wartoscia sprzed dostepu
+static int oczekujacy = -1;
+static uint16_t przed;
+static uint64_t oczekujacy_czas;
+
+// Obslugi przerwan z firmware'u - slabe, kazdy projekt ma inny zestaw
+#define ISR(nazwa) extern void nazwa(void) __attribute__((weak));
+ISR(_IC1Interrupt) ISR(_T1Interrupt) ISR(_IC2Interrupt) ISR(_T2Interrupt)
+ISR(_T3Interrupt) ISR(_ADC1Interrupt) ISR(_CompInterrupt) ISR(_CNInterrupt)
+ISR(_IC7Interrupt) ISR(_IC8Interrupt) ISR(_T4Interrupt) ISR(_T5Interrupt)
+ISR(_IC3Interrupt) ISR(_IC4Interrupt) ISR(_IC5Interrupt) ISR(_IC6Interrupt)
+ISR(_PMPInterrupt)
+
+typedef struct {
+    const char *nazwa;
+    void (*obsluga)(void);
+    uint8_t ifs, bit;           // flaga w IFSx (IECx lezy 3 rejestry dalej)
+    uint8_t ipc, przesuniecie;  // priorytet w IPCx
+} wektor_t;
+
+#define IEC(ifs) ((ifs) + (SFR_IEC0 - SFR_IFS0))
+
+// W kolejnosci naturalnej (numer wektora) - przy rownym priorytecie
+// wygrywa wczesniejszy, jak w PIC24
+static const wektor_t wektory[] = {
+    { "IC1",  _IC1Interrupt,  SFR_IFS0,  1, SFR_IPC0,   4 },
+    { "T1",   _T1Interrupt,   SFR_IFS0,  3, SFR_IPC0,  12 },
+    { "IC2",  _IC2Interrupt,  SFR_IFS0,  5, SFR_IPC1,   4 },
+    { "T2",   _T2Interrupt,   SFR_IFS0,  7, SFR_IPC1,  12 },
+    { "T3",   _T3Interrupt,   SFR_IFS0,  8, SFR_IPC2,   0 },
+    { "AD1",  _ADC1Interrupt, SFR_IFS0, 13, SFR_IPC3,   4 },
+    { "CMP",  _CompInterrupt, SFR_IFS1,  2, SFR_IPC4,   8 },
+    { "CN",   _CNInterrupt,   SFR_IFS1,  3, SFR_IPC4,  12 },
+    { "IC7",  _IC7Interrupt,  SFR_IFS1,  6, SFR_IPC5,   8 },
+    { "IC8",  _IC8Interrupt,  SFR_IFS1,  7, SFR_IPC5,  12 },
+    { "T4",   _T4Interrupt,   SFR_IFS1, 11, SFR_IPC6,  12 },
+    { "T5",   _T5Interrupt,   SFR_IFS1, 12, SFR_IPC7,   0 },
+    { "IC3",  _IC3Interrupt,  SFR_IFS2,  5, SFR_IPC9,   4 },
+    { "IC4",  _IC4Interrupt,  SFR_IFS2,  6, SFR_IPC9,   8 },
+    { "IC5",  _IC5Interrupt,  SFR_IFS2,  7, SFR_IPC9,  12 },
+    { "IC6",  _IC6Interrupt,  SFR_IFS2,  8, SFR_IPC10,  0 },
+    { "PMP",  _PMPInterrupt,  SFR_IFS2, 13, SFR_IPC11,  4 },
+};
+#define LICZBA_WEKTOROW (sizeof(wektory) / sizeof(wektory[0]))
+
+// Statystyki
+typedef struct {
+    uint64_t wywolania;
+    uint64_t cykle, cykle_max;  // wirtualne Tcy (z zagniezdzonymi)
+    uint64_t ns;                // czas PC
+} statystyka_t;
+
+static statystyka_t statystyki[LICZBA_WEKTOROW];
+static int glebokosc = 0;
+static uint64_t bezczynnosc = 0;            // Tcy spedzone w Idle()/Sleep()
+static uint64_t uspienie = 0;               // z tego w Sleep()
+static uint64_t aktywny_od = 0;             // ostatnie wybudzenie
+static uint64_t praca_ile = 0, praca_suma = 0, praca_max = 0;
+static struct timespec start;
+
+static uint64_t ns_teraz(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+void sim_slad(uint64_t kiedy, const char *format, ...) {
+    va_list a;
+
+    if(sim_cichy) {
+        return;
+    }
+    fprintf(slad, "%12.3f ms  ", SIM_MS(kiedy));
+    va_start(a, format);
+    vfprintf(slad, format, a);
+    va_end(a);
+    fputc('\n', slad);
+}
+
+void sim_blad(const char *format, ...) {
+    va_list a;
+
+    fflush(slad);
+    fprintf(stderr, "sim: %.3f ms: ", SIM_MS(sim_czas));
+    va_start(a, format);
+    vfprintf(stderr, format, a);
+    va_end(a);
+    fputc('\n', stderr);
+    exit(2);
+}
+
+static void podsumowanie(void) {
+    double wirtualny = SIM_MS(sim_czas) / 1000.0;
+    double rzeczywisty = (ns_teraz() - ((uint64_t)start.tv_sec * 1000000000ULL + start.tv_nsec)) / 1e9;
+    unsigned i;
+
+    fflush(slad);
+    fprintf(stderr, "\n== podsumowanie ==\n");
+    fprintf(stderr, "czas wirtualny    %12.3f s\n", wirtualny);
+    fprintf(stderr, "czas na PC        %12.3f s  (x%.0f)\n", rzeczywisty,
+            rzeczywisty > 0 ? wirtualny / rzeczywisty : 0.0);
+    fprintf(stderr, "CPU aktywny       %12.2f %%  (reszta w Idle/Sleep)\n",
+            sim_czas ? 100.0 * (sim_czas - bezczynnosc) / sim_czas : 0.0);
+    if(uspienie) {
+        fprintf(stderr, "w Sleep           %12.2f %%\n", 100.0 * uspienie / sim_czas);
+    }
+    if(praca_ile) {
+        fprintf(stderr, "praca miedzy Idle %12llu razy, sr %llu Tcy, max %llu Tcy\n",
+                (unsigned long long)praca_ile,
+                (unsigned long long)(praca_suma / praca_ile),
+                (unsigned long long)praca_max);
+    }
+    fprintf(stderr, "\nprzerwanie      wywolan   sr Tcy  max Tcy   sr ns PC\n");
+    for(i = 0; i < LICZBA_WEKTOROW; i++) {
+        const statystyka_t *s = &statystyki[i];
+        if(s->wywolania == 0) {
+            continue;
+        }
+        fprintf(stderr, "%-8s %14llu %8llu %8llu %10llu\n", wektory[i].nazwa,
+                (unsigned long long)s->wywolania,
+                (unsigned long long)(s->cykle / s->wywolania),
+                (unsigned long long)s->cykle_max,
+                (unsigned long long)(s->ns / s->wywolania));
+    }
+    peryferia_podsumowanie();
+}
+
+static void zakoncz(void) {
+    podsumowanie();
+    exit(0);
+}
+
+// Skutki zapisu, ktory firmware zrobil po poprzednim sim_sfr()
+static void zatwierdz(void) {
+    int r = oczekujacy;
+
+    if(r >= 0) {
+        oczekujacy = -1;
+        if(sim_rej[r] != przed) {
+            peryferia_zapis(r, przed, oczekujacy_czas);
+            sim_zmiana_zdarzen();
+        }
+    }
+}
+
+void sim_zmiana_zdarzen(void) {
+    uint64_t t = peryferia_nastepne();
+    uint64_t s = scenariusz_nastepne();
+
+    if(s < t) {
+        t = s;
+    }
+    if(koniec < t) {
+        t = koniec;
+    }
+    nastepne = t;
+}
+
+static void zdarzenia(void) {
+    peryferia_dogon();
+    scenariusz_wykonaj();
+    if(sim_czas >= koniec) {
+        zakoncz();
+    }
+    sim_zmiana_zdarzen();
+}
+
+static int oczekuje_przerwanie(void) {
+    return ((sim_rej[SFR_IFS0] & sim_rej[SFR_IEC0]) |
+            (sim_rej[SFR_IFS1] & sim_rej[SFR_IEC1]) |
+            (sim_rej[SFR_IFS2] & sim_rej[SFR_IEC2])) != 0;
+}
+
+static void przerwania(void);
+
+// Wykonanie dt cykli biezacego kontekstu. Przerwanie zgloszone w trakcie
+// jest obslugiwane w chwili zgloszenia, a reszta dt wykonuje sie po nim.
+static void uplyw(uint64_t dt) {
+    while(nastepne <= sim_czas + dt) {
+        dt -= nastepne - sim_czas;
+        sim_czas = nastepne;
+        zdarzenia();
+        przerwania();
+    }
+    sim_czas += dt;
+}
+
+static void wywolaj(unsigned i, int priorytet) {
+    const wektor_t *w = &wektory[i];
+    statystyka_t *s = &statystyki[i];
+    uint16_t ipl = sim_rej[SFR_SR] & 0x00E0;
+    uint64_t t0 = sim_czas;
+    uint64_t h0 = ns_teraz();
+    uint64_t cykle;
+
+    if(w->obsluga == NULL) {
+        sim_blad("przerwanie %s wlaczone bez obslugi (PIC24 zrobilby reset)", w->nazwa);
+    }
+
+    // Wejscie: CPU przyjmuje priorytet przerwania
+    sim_rej[SFR_SR] = (sim_rej[SFR_SR] & ~0x00E0) | (priorytet << 5);
+    glebokosc++;
+    uplyw(SIM_KOSZT_PRZERWANIA / 2);
+    w->obsluga();
+    zatwierdz();
+    uplyw(SIM_KOSZT_PRZERWANIA / 2);
+    glebokosc--;
+    // RETFIE przywraca IPL
+    sim_rej[SFR_SR] = (sim_rej[SFR_SR] & ~0x00E0) | ipl;
+
+    cykle = sim_czas - t0;
+    s->wywolania++;
+    s->cykle += cykle;
+    if(cykle > s->cykle_max) {
+        s->cykle_max = cykle;
+    }
+    s->ns += ns_teraz() - h0;
+}
+
+// Obsluga wszystkich zgloszonych przerwan o priorytecie wyzszym niz CPU
+static void przerwania(void) {
+    for(;;) {
+        // Szybka sciezka - wolana po kazdym dostepie, zwykle nic nie czeka
+        if(!oczekuje_przerwanie()) {
+            return;
+        }
+
+        int ipl = (sim_rej[SFR_SR] >> 5) & 7;
+        int wybrany = -1;
+        unsigned i;
+
+        if(glebokosc > 0 && (sim_rej[SFR_INTCON1] & 0x8000)) {
+            return;         // NSTDIS - bez zagniezdzania
+        }
+        for(i = 0; i < LICZBA_WEKTOROW; i++) {
+            const wektor_t *w = &wektory[i];
+            if(sim_rej[w->ifs] & sim_rej[IEC(w->ifs)] & (1u << w->bit)) {
+                int p = (sim_rej[w->ipc] >> w->przesuniecie) & 7;
+                if(p > ipl) {
+                    ipl = p;
+                    wybrany = i;
+                }
+            }
+        }
+        if(wybrany < 0) {
+            return;
+        }
+        wywolaj(wybrany, ipl);
+    }
+}
+
+void sim_dostep(void) {
+    zatwierdz();
+    uplyw(1);
+    peryferia_dogon();
+    przerwania();
+}
+
+volatile uint16_t *sim_sfr(int r) {
+    sim_dostep();
+    peryferia_odczyt(r);
+    oczekujacy = r;
+    przed = sim_rej[r];
+    oczekujacy_czas = sim_czas;
+    return &sim_rej[r];
+}
+
+void sim_nop(void) {
+    zatwierdz();
+    uplyw(1);
+    przerwania();
+}
+
+void sim_petla(void) {
+    zatwierdz();
+    uplyw(SIM_KOSZT_PETLI);
+    przerwania();
+}
+
+void __delay32(unsigned long cykle) {
+    zatwierdz();
+    uplyw(cykle);
+    przerwania();
+}
+
+// Idle()/Sleep(): CPU stoi do pierwszego wlaczonego przerwania (niezaleznie
+// od priorytetu). Przy IPL wyzszym od przerwania CPU budzi sie bez obslugi.
+static void bezczynnosc_do_przerwania(int sen) {
+    uint64_t praca;
+
+    zatwierdz();
+    uplyw(1);
+
+    praca = sim_czas - aktywny_od;
+    praca_ile++;
+    praca_suma += praca;
+    if(praca > praca_max) {
+        praca_max = praca;
+    }
+
+    sim_uspiony = sen;
+    sim_zmiana_zdarzen();       // w Sleep timery nie dadza zdarzen
+    while(!oczekuje_przerwanie()) {
+        bezczynnosc += nastepne - sim_czas;
+        if(sen) {
+            uspienie += nastepne - sim_czas;
+        }
+        sim_czas = nastepne;
+        zdarzenia();
+    }
+    sim_uspiony = 0;
+    sim_zmiana_zdarzen();
+    aktywny_od = sim_czas;
+    przerwania();
+}
+
+void sim_idle(void) {
+    bezczynnosc_do_przerwania(0);
+}
+
+// W Sleep stoja timery taktowane Tcy (ADC z zegarem Tcy tez, ale model tego
+// nie sprawdza), wiec budza tylko np. CN i komparatory
+void sim_sleep(void) {
+    bezczynnosc_do_przerwania(1);
+}
+
+extern int firmware_main(void);
+
+static void uzycie(const char *program) {
+    fprintf(stderr,
+            "uzycie: %s [-q] [-o plik] [scenariusz]\n"
+            "  -q       bez sladu LATA/LCD, tylko podsumowanie\n"
+            "  -o plik  slad do pliku zamiast na stdout\n",
+            program);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *plik = NULL;
+    int i;
+
+    slad = stdout;
+    for(i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-q") == 0) {
+            sim_cichy = 1;
+        } else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            slad = fopen(argv[++i], "w");
+            if(slad == NULL) {
+                perror(argv[i]);
+                return 2;
+            }
+        } else if(argv[i][0] == '-' || plik != NULL) {
+            uzycie(argv[0]);
+        } else {
+            plik = argv[i];
+        }
+    }
+
+    peryferia_reset();
+    if(plik != NULL && scenariusz_wczytaj(plik) != 0) {
+        return 2;
+    }
+    koniec = scenariusz_koniec();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    scenariusz_wykonaj();
+    sim_zmiana_zdarzen();
+
+    firmware_main();
+    sim_blad("firmware_main() zakonczyl sie");
+    return 2;
+}
@@ -0,0 +1,72 @@
+/*
+ * File:   sim.h
+ * Author: Jakub Budzich - 169224
+ *
+ * Model PIC24FJ128GA010 + Explorer16 do uruchamiania firmware'ow na PC.
+ *
+ * Firmware kompiluje sie bez zmian przeciwko include/ - kazdy dostep do
+ * rejestru idzie przez sim_sfr(), ktore:
+ *  - zatwierdza poprzedni dostep (wykrywa zapis i wywoluje jego skutki),
+ *  - posuwa wirtualny czas o 1 Tcy i dogania peryferia,
+ *  - wywoluje przerwania o priorytecie wyzszym niz biezacy IPL.
+ * Idle()/Sleep() przeskakuja od razu do nastepnego zdarzenia, dzieki czemu
+ * godziny pracy licza sie w sekundy (w Sleep timery taktowane Tcy stoja). Czas wykonania kodu jest przyblizony
+ * (1 Tcy na dostep do rejestru i NOP, SIM_KOSZT_PETLI na obrot while),
+ * dokladne sa za to timery, ADC, LCD i momenty zdarzen ze scenariusza.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include "p24FJ128GA010.h"
+#include "taktowanie.h"
+
+// Przyblizony koszt jednego obrotu petli while przy -O0. Razem z Nop()
+// daje CYCLES_PER_DELAY_LOOP z lcd.c, wiec LCD_Wait trwa tyle co na PIC24.
+#ifndef SIM_KOSZT_PETLI
+#define SIM_KOSZT_PETLI     11
+#endif
+
+// Wejscie i wyjscie z przerwania (opoznienie + RETFIE)
+#define SIM_KOSZT_PRZERWANIA 8
+
+#define SIM_BRAK_ZDARZENIA  UINT64_MAX
+
+#define SIM_CYKLE_MS(ms)    ((uint64_t)(ms) * (FCY / 1000UL))
+#define SIM_MS(cykle)       ((double)(cykle) / (FCY / 1000UL))
+
+// sim.c - rdzen: rejestry, czas, przerwania
+extern uint16_t sim_rej[SFR_LICZBA];    // zawartosc rejestrow (bez skutkow)
+extern uint64_t sim_czas;               // wirtualny czas w Tcy
+extern int sim_cichy;                   // 1 - bez sladu, tylko podsumowanie
+extern int sim_uspiony;                 // 1 - CPU w Sleep(), zegar Tcy stoi
+
+void sim_dostep(void);                  // dostep do rejestru poza sim_sfr()
+void sim_zmiana_zdarzen(void);          // peryferia zmienily termin zdarzenia
+void sim_slad(uint64_t kiedy, const char *format, ...);
+void sim_blad(const char *format, ...);
+
+// peryferia.c - timery, CN, IC, ADC, komparatory, PMP z modelem HD44780
+void peryferia_reset(void);
+void peryferia_dogon(void);             // stan peryferiow na chwile sim_czas
+uint64_t peryferia_nastepne(void);      // najblizsze zdarzenie peryferiow
+void peryferia_odczyt(int rej);         // skutki odczytu (przed dostepem)
+void peryferia_zapis(int rej, uint16_t stara, uint64_t kiedy);
+void peryferia_podsumowanie(void);
+
+void sim_pin(int port, int bit, int wartosc);   // port: 0 = A ... 6 = G
+void sim_analog(int kanal, uint16_t wartosc);   // 0..1023
+uint16_t sim_analog_wartosc(int kanal);
+void sim_ekran(void);                           // zawartosc LCD do sladu
+
+void sim_pmp_zapis(uint16_t dana);
+uint16_t sim_pmp_odczyt(void);
+
+// scenariusz.c - wejscia w czasie
+int scenariusz_wczytaj(const char *plik);
+uint64_t scenariusz_nastepne(void);
+void scenariusz_wykonaj(void);          // zdarzenia z terminem <= sim_czas
+uint64_t scenariusz_koniec(void);
+
+#endif // SIM_H